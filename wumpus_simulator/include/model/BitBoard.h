@@ -0,0 +1,270 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "GroundTile.h"
+#include "WorldGenerator.h"
+#include "WumpusEnums.h"
+
+#include <stdint.h>
+
+namespace wumpus_simulator
+{
+/**
+ * Complete state of a single agent world of up to 8x8 tiles, packed into one
+ * uint64_t bit plane per kind of object. Tile x, y is bit x * N + y, following
+ * the coordinates of the simulator (x grows downwards, y to the right).
+ * Moving, perceiving and shooting are plain shifts and masks, and the struct is
+ * trivially copyable, so it can be cloned for search or stored in replay buffers.
+ * Follows the rules of the simulator with static wumpus.
+ */
+template <int N>
+struct BitBoard
+{
+    static_assert(N >= 2 && N <= 8, "BitBoard supports 2x2 up to 8x8 worlds");
+
+    /**
+     * Bits of the responses returned by act
+     */
+    typedef uint32_t ResponseMask;
+
+    static constexpr uint64_t bit(int x, int y)
+    {
+        return uint64_t(1) << (x * N + y);
+    }
+
+    static constexpr uint64_t ALL = N * N == 64 ? ~uint64_t(0) : (uint64_t(1) << (N * N)) - 1;
+
+    /**
+     * All tiles with y == column
+     */
+    static constexpr uint64_t columnMask(int column, int row = N - 1)
+    {
+        return row < 0 ? 0 : bit(row, column) | columnMask(column, row - 1);
+    }
+
+    static constexpr uint64_t FIRST_COLUMN = columnMask(0);
+    static constexpr uint64_t LAST_COLUMN = columnMask(N - 1);
+
+    /**
+     * Moves every tile of the plane one step into the given WumpusEnums::heading, tiles leaving the field are dropped
+     */
+    static uint64_t shift(uint64_t plane, int heading)
+    {
+        switch (heading) {
+        case WumpusEnums::heading::up:
+            return plane >> N;
+        case WumpusEnums::heading::down:
+            return (plane << N) & ALL;
+        case WumpusEnums::heading::left:
+            return (plane & ~FIRST_COLUMN) >> 1;
+        default:
+            return (plane & ~LAST_COLUMN) << 1;
+        }
+    }
+
+    /**
+     * Tiles next to any tile of the plane
+     */
+    static uint64_t neighbours(uint64_t plane)
+    {
+        return (plane >> N) | ((plane << N) & ALL) | ((plane & ~FIRST_COLUMN) >> 1) | ((plane & ~LAST_COLUMN) << 1);
+    }
+
+    static bool has(ResponseMask responses, WumpusEnums::responses response)
+    {
+        return responses & (ResponseMask(1) << response);
+    }
+
+    enum flags
+    {
+        arrowFlag = 1,
+        goldFlag = 2,
+        deadFlag = 4,
+        exitedFlag = 8
+    };
+
+    uint64_t traps;
+    uint64_t wumpus;
+    uint64_t gold;
+    uint64_t visited;
+    uint8_t x;
+    uint8_t y;
+    uint8_t startX;
+    uint8_t startY;
+    uint8_t heading;
+    uint8_t state;
+
+    /**
+     * Builds the board of a generated layout with the agent on its start tile, facing up like in the simulator
+     */
+    static BitBoard fromLayout(const WorldLayout& layout, int startX, int startY, bool arrow)
+    {
+        BitBoard board;
+        board.traps = 0;
+        board.wumpus = 0;
+        for (auto& trap : layout.traps) {
+            board.traps |= bit(trap.first, trap.second);
+        }
+        for (auto& pos : layout.wumpus) {
+            board.wumpus |= bit(pos.first, pos.second);
+        }
+        board.gold = bit(layout.gold.first, layout.gold.second);
+        board.visited = bit(startX, startY);
+        board.x = startX;
+        board.y = startY;
+        board.startX = startX;
+        board.startY = startY;
+        board.heading = WumpusEnums::heading::up;
+        board.state = arrow ? arrowFlag : 0;
+        return board;
+    }
+
+    uint64_t position() const
+    {
+        return bit(this->x, this->y);
+    }
+
+    bool isOver() const
+    {
+        return this->state & (deadFlag | exitedFlag);
+    }
+
+    /**
+     * What the agent perceives on its tile as combination of GroundTile::perceptionMask bits
+     */
+    uint8_t perceive() const
+    {
+        uint64_t pos = position();
+        return ((this->gold & pos) ? GroundTile::shinyMask : 0) | ((neighbours(this->traps) & pos) ? GroundTile::draftyMask : 0) |
+                ((neighbours(this->wumpus) & pos) ? GroundTile::stinkyMask : 0);
+    }
+
+    /**
+     * Applies one action and returns the responses the simulator would send, including the perception
+     */
+    ResponseMask act(WumpusEnums::actions action)
+    {
+        ResponseMask responses = 0;
+        if (isOver()) {
+            return ResponseMask(1) << WumpusEnums::responses::notAllowed;
+        }
+        switch (action) {
+        case WumpusEnums::actions::move: {
+            uint64_t next = shift(position(), this->heading);
+            if (next == 0) {
+                responses |= ResponseMask(1) << WumpusEnums::responses::bump;
+                break;
+            }
+            this->x += (this->heading == WumpusEnums::heading::down) - (this->heading == WumpusEnums::heading::up);
+            this->y += (this->heading == WumpusEnums::heading::right) - (this->heading == WumpusEnums::heading::left);
+            this->visited |= next;
+            if (next & (this->traps | this->wumpus)) {
+                this->state |= deadFlag;
+                responses |= ResponseMask(1) << WumpusEnums::responses::dead;
+            }
+            break;
+        }
+        case WumpusEnums::actions::turnLeft:
+            this->heading = (this->heading + 1) % 4;
+            break;
+        case WumpusEnums::actions::turnRight:
+            this->heading = (this->heading + 3) % 4;
+            break;
+        case WumpusEnums::actions::shoot: {
+            if (!(this->state & arrowFlag)) {
+                responses |= ResponseMask(1) << WumpusEnums::responses::notAllowed;
+                break;
+            }
+            // The arrow flies until it leaves the field and kills every wumpus on its way
+            uint64_t ray = 0;
+            for (uint64_t tile = shift(position(), this->heading); tile != 0; tile = shift(tile, this->heading)) {
+                ray |= tile;
+            }
+            responses |= ResponseMask(1) << ((ray & this->wumpus) ? WumpusEnums::responses::scream : WumpusEnums::responses::silence);
+            this->wumpus &= ~ray;
+            this->state &= ~arrowFlag;
+            break;
+        }
+        case WumpusEnums::actions::pickUpGold:
+            if (this->gold & position()) {
+                responses |= ResponseMask(1) << WumpusEnums::responses::goldFound;
+                this->state |= goldFlag;
+            } else {
+                responses |= ResponseMask(1) << WumpusEnums::responses::notAllowed;
+            }
+            break;
+        case WumpusEnums::actions::leave:
+            if ((this->state & goldFlag) && this->x == this->startX && this->y == this->startY) {
+                this->state |= exitedFlag;
+                return ResponseMask(1) << WumpusEnums::responses::exited;
+            }
+            // Like the simulator, leaving reports no perception
+            return ResponseMask(1) << WumpusEnums::responses::notAllowed;
+        }
+        uint8_t perception = perceive();
+        responses |= (perception & GroundTile::shinyMask) ? ResponseMask(1) << WumpusEnums::responses::shiny : 0;
+        responses |= (perception & GroundTile::draftyMask) ? ResponseMask(1) << WumpusEnums::responses::drafty : 0;
+        responses |= (perception & GroundTile::stinkyMask) ? ResponseMask(1) << WumpusEnums::responses::stinky : 0;
+        return responses;
+    }
+
+    /**
+     * Bit parallel version of WorldGenerator::getGoldDistance for the given layout
+     */
+    static int getGoldDistance(const WorldLayout& layout)
+    {
+        uint64_t deadly = 0;
+        for (auto& trap : layout.traps) {
+            deadly |= bit(trap.first, trap.second);
+        }
+        for (auto& pos : layout.wumpus) {
+            deadly |= bit(pos.first, pos.second);
+        }
+        uint64_t gold = bit(layout.gold.first, layout.gold.second);
+        // Agents are spawned away from hazards, breeze, stench and gold
+        uint64_t start = ALL & ~(deadly | neighbours(deadly) | gold);
+
+        uint64_t visited = gold;
+        uint64_t open = gold;
+        for (int distance = 0; open != 0; distance++) {
+            if (open & start) {
+                return distance;
+            }
+            open = neighbours(open) & ~visited & ~deadly;
+            visited |= open;
+        }
+        return -1;
+    }
+};
+
+template <int N>
+constexpr uint64_t BitBoard<N>::ALL;
+template <int N>
+constexpr uint64_t BitBoard<N>::FIRST_COLUMN;
+template <int N>
+constexpr uint64_t BitBoard<N>::LAST_COLUMN;
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,322 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "WumpusEnums.h"
+#include "Zobrist.h"
+
+#include <memory>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace wumpus_simulator
+{
+class WumpusBehaviour;
+
+/**
+ * Refers to an entity of the EntityRegistry. A handle goes stale when its entity is
+ * destroyed or the registry is cleared, even if the slot is reused afterwards.
+ */
+struct EntityHandle
+{
+    uint32_t index;
+    uint32_t generation;
+
+    EntityHandle()
+            : index(0)
+            , generation(0)
+    {
+    }
+
+    EntityHandle(uint32_t index, uint32_t generation)
+            : index(index)
+            , generation(generation)
+    {
+    }
+
+    /**
+     * False for default constructed handles, which refer to no entity at all
+     */
+    bool isValid() const
+    {
+        return generation != 0;
+    }
+
+    bool operator==(const EntityHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const EntityHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Stores all agents and wumpus as dense arrays of components indexed by slot.
+ * Freed slots are reused by later entities, clear() frees all of them at the end
+ * of an episode while keeping the allocated memory.
+ */
+class EntityRegistry
+{
+public:
+    enum kind : uint8_t
+    {
+        none,
+        agent,
+        wumpus
+    };
+
+    EntityRegistry();
+    virtual ~EntityRegistry();
+
+    /**
+     * Creates an entity standing at x and y, agents start facing up without arrow and gold
+     */
+    EntityHandle create(kind type, int id, int x, int y);
+
+    /**
+     * Frees the slot of the entity, all handles to it go stale
+     */
+    void destroy(EntityHandle entity);
+
+    /**
+     * Destroys all entities
+     */
+    void clear();
+
+    /**
+     * True if the handle refers to an entity that has not been destroyed
+     */
+    bool isAlive(EntityHandle entity) const
+    {
+        return entity.isValid() && entity.index < this->generations.size() && this->generations[entity.index] == entity.generation &&
+                this->kinds[entity.index] != none;
+    }
+
+    /**
+     * Returns the living entity of the given kind with the given id, an invalid handle if there is none.
+     * Unpossessed wumpus all share the id 0, any of them may be returned for it.
+     */
+    EntityHandle find(int id, kind type);
+
+    /**
+     * Zobrist hash of all living entities and their components, independent of the slots
+     */
+    uint64_t getHash() const
+    {
+        return this->hash;
+    }
+
+    /**
+     * Returns the living entities whose components changed since the last call
+     */
+    std::vector<EntityHandle> takeChangedEntities();
+
+    /**
+     * Number of living entities
+     */
+    size_t size() const
+    {
+        return this->kinds.size() - this->freeSlots.size();
+    }
+
+    /**
+     * Calls function with the handle of every living entity in slot order.
+     * Entities may be destroyed, but not created, while iterating.
+     */
+    template <typename Function>
+    void forEach(Function function) const
+    {
+        for (uint32_t i = 0; i < this->kinds.size(); i++) {
+            if (this->kinds[i] != none) {
+                function(EntityHandle(i, this->generations[i]));
+            }
+        }
+    }
+
+    // Components, the handles have to be alive
+    kind getKind(EntityHandle entity) const
+    {
+        return (kind) this->kinds[entity.index];
+    }
+
+    int getId(EntityHandle entity) const
+    {
+        return this->ids[entity.index];
+    }
+
+    void setId(EntityHandle entity, int id)
+    {
+        removeFromLookup(entity.index);
+        this->hash ^= getKey(entity.index);
+        this->ids[entity.index] = id;
+        this->hash ^= getKey(entity.index);
+        addToLookup(entity.index);
+        touch(entity.index);
+    }
+
+    int getX(EntityHandle entity) const
+    {
+        return this->xs[entity.index];
+    }
+
+    int getY(EntityHandle entity) const
+    {
+        return this->ys[entity.index];
+    }
+
+    void setPosition(EntityHandle entity, int x, int y)
+    {
+        this->hash ^= getKey(entity.index);
+        this->xs[entity.index] = x;
+        this->ys[entity.index] = y;
+        this->hash ^= getKey(entity.index);
+        touch(entity.index);
+    }
+
+    WumpusEnums::heading getHeading(EntityHandle entity) const
+    {
+        return (WumpusEnums::heading) this->headings[entity.index];
+    }
+
+    void setHeading(EntityHandle entity, WumpusEnums::heading heading)
+    {
+        this->hash ^= getKey(entity.index);
+        this->headings[entity.index] = heading;
+        this->hash ^= getKey(entity.index);
+        touch(entity.index);
+    }
+
+    bool hasArrow(EntityHandle entity) const
+    {
+        return this->arrows[entity.index];
+    }
+
+    void setArrow(EntityHandle entity, bool value)
+    {
+        this->hash ^= getKey(entity.index);
+        this->arrows[entity.index] = value;
+        this->hash ^= getKey(entity.index);
+        touch(entity.index);
+    }
+
+    bool hasGold(EntityHandle entity) const
+    {
+        return this->golds[entity.index];
+    }
+
+    void setHasGold(EntityHandle entity, bool value)
+    {
+        this->hash ^= getKey(entity.index);
+        this->golds[entity.index] = value;
+        this->hash ^= getKey(entity.index);
+        touch(entity.index);
+    }
+
+    /**
+     * Behaviour used while the wumpus is not possessed, null if it stands still
+     */
+    const std::shared_ptr<WumpusBehaviour>& getBehaviour(EntityHandle entity) const
+    {
+        return this->behaviours[entity.index];
+    }
+
+    void setBehaviour(EntityHandle entity, std::shared_ptr<WumpusBehaviour> behaviour)
+    {
+        this->behaviours[entity.index] = behaviour;
+    }
+
+private:
+    std::vector<uint8_t> kinds;
+    std::vector<uint32_t> generations;
+    std::vector<int32_t> ids;
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+    std::vector<uint8_t> headings;
+    std::vector<uint8_t> arrows;
+    std::vector<uint8_t> golds;
+    std::vector<std::shared_ptr<WumpusBehaviour>> behaviours;
+    std::vector<uint8_t> changed;
+    uint64_t hash;
+
+    /**
+     * Slots changed since the last takeChangedEntities
+     */
+    std::vector<uint32_t> changedSlots;
+
+    /**
+     * Free slots, used as a stack
+     */
+    std::vector<uint32_t> freeSlots;
+
+    /**
+     * Slot of every living entity with an id other than 0, by getIdKey
+     */
+    std::unordered_map<uint64_t, uint32_t> slotsById;
+
+    /**
+     * Per kind the slots that got the shared id 0, find drops entries that changed since
+     */
+    std::vector<uint32_t> sharedSlots[3];
+
+    static uint64_t getIdKey(uint8_t type, int id)
+    {
+        return ((uint64_t) type << 32) | (uint32_t) id;
+    }
+
+    /**
+     * Adds the living entity in the slot to the id lookup
+     */
+    void addToLookup(uint32_t index);
+
+    /**
+     * Removes the entity in the slot from the id lookup
+     */
+    void removeFromLookup(uint32_t index);
+
+    /**
+     * Zobrist key of the entity in the slot. It covers all components, so it does not
+     * depend on the slot and unpossessed wumpus with the same id cannot cancel out.
+     */
+    uint64_t getKey(uint32_t index) const
+    {
+        uint64_t state = this->headings[index] | (this->arrows[index] << 2) | (this->golds[index] << 3);
+        uint64_t location = ((uint64_t) this->kinds[index] << 32) | (uint32_t) this->ids[index];
+        return Zobrist::key(location, Zobrist::entity, Zobrist::mix(Zobrist::tileLocation(this->xs[index], this->ys[index])) + state);
+    }
+
+    void touch(uint32_t index)
+    {
+        if (!this->changed[index]) {
+            this->changed[index] = true;
+            this->changedSlots.push_back(index);
+        }
+    }
+};
+
+} /* namespace wumpus_simulator */
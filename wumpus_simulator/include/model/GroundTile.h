@@ -24,11 +24,15 @@
 
 #pragma once
 
+#include "EntityRegistry.h"
+#include "SpawnTiles.h"
+#include "Zobrist.h"
+
 #include <memory>
+#include <stdint.h>
 
 namespace wumpus_simulator
 {
-class Movable;
 /**
  * Basic element of the field
  */
@@ -36,6 +40,16 @@ class GroundTile
 {
 
 public:
+    /**
+     * Bits of the perception mask
+     */
+    enum perceptionMask
+    {
+        shinyMask = 1,
+        draftyMask = 2,
+        stinkyMask = 4
+    };
+
     GroundTile(int x, int y);
     virtual ~GroundTile();
     int getX();
@@ -45,29 +59,76 @@ public:
     void setTrap(bool value);
     void setStench(bool value);
     void setGold(bool value);
-    std::shared_ptr<Movable> getMovable();
-    void setMovable(std::shared_ptr<Movable> movable);
+
+    /**
+     * Agent or wumpus standing on this tile, an invalid handle if there is none
+     */
+    EntityHandle getEntity();
+    void setEntity(EntityHandle entity, EntityRegistry::kind type);
+    void clearEntity();
     void setBreeze(bool hasBreeze);
 
     int getStartAgentID();
     bool getTrap();
     bool getGold();
     bool getStench();
-    bool hasMovable();
+    bool hasEntity();
     bool getBreeze();
     bool getStartpoint();
     bool hasWumpus();
+    bool hasAgent();
+
+    /**
+     * True if the tile was handed out for writing since the last PlayGround::takeDirtyTiles
+     */
+    bool isDirty();
+    void setDirty(bool value);
+
+    /**
+     * Hash of the playground that is updated on every change of this tile, null to not hash it
+     */
+    void setHash(uint64_t* hash);
+
+    /**
+     * Set of spawn tiles that this tile joins and leaves on every change, null to not track it
+     */
+    void setSpawnTiles(SpawnTiles* spawnTiles);
+
+    /**
+     * Everything an agent perceives on this tile as combination of perceptionMask bits.
+     * Kept up to date by setGold, setBreeze and setStench.
+     */
+    uint8_t getPerception()
+    {
+        return perception;
+    }
 
 private:
     int x;
     int y;
     int startAgentID;
     bool hasTrap;
-    bool hasGold;
-    bool hasStench;
-    bool hasBreeze;
     bool isStartpoint;
-    std::shared_ptr<Movable> movable;
+    uint8_t perception;
+    uint8_t entityKind;
+    bool dirty;
+    EntityHandle entity;
+    uint64_t* hash;
+    SpawnTiles* spawnTiles;
+    /**
+     * Membership in spawnTiles, plain dirt is a member
+     */
+    bool spawnable;
+
+    /**
+     * Adds or removes the feature from the hash
+     */
+    void toggle(Zobrist::feature type, uint64_t value = 1);
+
+    /**
+     * Agents are only spawned on empty tiles without any hazard, perception or start point
+     */
+    void updateSpawnable();
 };
 
 } /* namespace wumpus_simulator */
\ No newline at end of file
@@ -24,32 +24,47 @@
 
 #pragma once
 
-#include "GroundTile.h"
+#include "TileBitset.h"
 
-#include <QString>
-
-#include <memory>
+#include <stddef.h>
 
 namespace wumpus_simulator
 {
 /**
- * Interface for every object that can be moved from outside the simulator
+ * What a single agent knows about the playground, two bits per tile:
+ * visited tiles and perceived tiles. Perceptions on a tile tell something about
+ * its neighbours, so a visit perceives the tile itself and its four neighbours.
  */
-class Movable
+class KnowledgeMap
 {
 public:
-    Movable();
-    virtual ~Movable();
-    QString getType();
-    std::shared_ptr<GroundTile> getTile();
-    void setTile(std::shared_ptr<GroundTile> tile);
-    int getId();
-    void setId(int id);
-
-protected:
-    int id;
-    std::shared_ptr<GroundTile> tile;
-    QString type;
+    KnowledgeMap(int size);
+    virtual ~KnowledgeMap();
+
+    /**
+     * Marks the tile as visited and the tile and its neighbours as perceived
+     */
+    void visit(int x, int y);
+
+    bool isVisited(int x, int y) const;
+    bool isPerceived(int x, int y) const;
+    int getVisitedCount() const;
+    int getPerceivedCount() const;
+    const TileBitset& getVisited() const;
+    const TileBitset& getPerceived() const;
+
+    /**
+     * Memory used by both bitsets in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    TileBitset visited;
+    TileBitset perceived;
+    int visitedCount;
+    int perceivedCount;
+
+    void perceive(int x, int y);
 };
 
 } /* namespace wumpus_simulator */
@@ -24,20 +24,27 @@
 
 #pragma once
 
+#include "EntityRegistry.h"
 #include "GroundTile.h"
-#include "Movable.h"
+#include "KnowledgeMap.h"
+#include "PlayGround.h"
+#include "RenderSnapshot.h"
+#include "WorldGenerator.h"
 
 #include <qdebug.h>
 #include <ros/ros.h>
 
+#include <map>
 #include <memory>
+#include <random>
+#include <stdint.h>
 #include <vector>
 
 namespace wumpus_simulator
 {
 
-class Wumpus;
-class Agent;
+struct WorldRecord;
+struct WorldTile;
 
 /**
  * Encapsulates all necessary information for current simulation.
@@ -50,7 +57,13 @@ public:
      * @return Model*
      */
     static Model* get();
+
+    /**
+     * Creates an independent model, e.g. for offline tools. The simulator itself uses get().
+     */
+    Model();
     virtual ~Model();
+
     /**
      * Creates a new model and initializes it with the given values.
      * @param agentHasArrow bool Determines if the agents can shoot an arrow
@@ -61,32 +74,83 @@ public:
     void init(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize);
 
     /**
-     * Returns the tile located at x and y
+     * Like init, but with a fixed seed, so the same world can be created again
+     * @param seed unsigned int seed of the world generator
+     */
+    void init(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize, unsigned int seed);
+
+    /**
+     * Like init, but only accepts worlds in which the gold can be reached safely
+     * from at least one possible start tile. Candidates are generated in parallel.
+     * @param threadCount int number of generator threads, 0 uses all cores
+     */
+    void initSolvable(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize, int threadCount);
+
+    /**
+     * Like initSolvable, but searches the candidates starting at the given seed
+     */
+    void initSolvable(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize, int threadCount, unsigned int seed);
+
+    /**
+     * Creates a new model from an already generated layout.
+     * @param agentHasArrow bool Determines if the agents can shoot an arrow
+     * @param layout WorldLayout positions of traps, wumpus and gold
+     */
+    void init(bool agentHasArrow, const WorldLayout& layout);
+
+    /**
+     * Suppresses the progress messages of init, e.g. for batch tools creating many worlds
+     */
+    void setQuiet(bool quiet);
+
+    /**
+     * Returns the tile located at x and y. Allocates the tile if it is still untouched,
+     * so use it only if the tile is going to be modified.
      * @return shared_ptr<GroundTile>
      */
     std::shared_ptr<GroundTile> getTile(int x, int y);
 
+    /**
+     * Returns the tile located at x and y for reading only. Untouched tiles are
+     * represented by a shared plain dirt tile.
+     * @return shared_ptr<GroundTile>
+     */
+    std::shared_ptr<GroundTile> peekTile(int x, int y);
+
+    /**
+     * Returns the tile the entity is standing on and marks it as dirty, like getTile(x, y)
+     * @return shared_ptr<GroundTile>
+     */
+    std::shared_ptr<GroundTile> getTile(EntityHandle entity);
+
+    /**
+     * Returns the tile the entity is standing on for reading only, e.g. for perceptions
+     * @return shared_ptr<GroundTile>
+     */
+    std::shared_ptr<GroundTile> peekTile(EntityHandle entity);
+
     // Getters
     bool getAgentHasArrow();
     int getPlayGroundSize();
     int getTrapCount();
     int getWumpusCount();
-    std::vector<std::vector<std::shared_ptr<GroundTile>>> getPlayGround();
+    unsigned int getSeed();
+    PlayGround& getPlayGround();
 
     /**
-     * A vector of all wumpus and agents
+     * All wumpus and agents
      */
-    std::vector<std::shared_ptr<Movable>> movables;
+    EntityRegistry entities;
 
     /**
-     * Returns the agent with the given ID. Returns null if not found.
+     * Returns the agent with the given ID. Returns an invalid handle if not found.
      */
-    std::shared_ptr<Agent> getAgentByID(int id);
+    EntityHandle getAgentByID(int id);
 
     /**
-     * Returns the wumpus with the given ID. Returns null if not found.
+     * Returns the wumpus with the given ID. Returns an invalid handle if not found.
      */
-    std::shared_ptr<Wumpus> getWumpusByID(int id);
+    EntityHandle getWumpusByID(int id);
 
     /**
      * Serializes the complete model to a QJsoinObject
@@ -99,39 +163,113 @@ public:
     void fromJSON(QJsonObject root);
 
     /**
-     * Removes only the visual representation of given agent
+     * Replaces the model with an already decoded world, see WorldLibrary
+     */
+    void fromRecord(const WorldRecord& world);
+
+    /**
+     * Fills the record with the tiles changed since the last call, including tiles whose entity changed.
+     * Costs O(changed tiles) and resets the change tracking.
+     * @return number of resets of the playground, changes of different resets must not be merged
+     */
+    uint32_t takeChanges(WorldRecord& changes);
+
+    /**
+     * Fills the record with all allocated tiles without touching the change tracking
+     * @return number of resets of the playground
+     */
+    uint32_t toRecord(WorldRecord& world);
+
+    /**
+     * Creates a snapshot of the current state for readers on other threads. Chunks that did not
+     * change since previous are shared with it, so are pages of the chunk table without changes.
+     * A new world or a null previous copies all chunks.
+     * @param previous the last snapshot created by this model
      */
-    void removeAgent(std::shared_ptr<Agent> agent);
+    std::shared_ptr<const RenderSnapshot> takeSnapshot(const std::shared_ptr<const RenderSnapshot>& previous);
+
+    /**
+     * 64 bit Zobrist hash of tiles and entities, maintained on every change in O(1).
+     * Equal worlds have equal hashes, in every process.
+     */
+    uint64_t getHash();
+
+    /**
+     * Chooses a random tile without hazard, perception, entity or start point in O(1)
+     * @return false if no such tile is left
+     */
+    bool pickSpawnTile(std::minstd_rand& random, int& x, int& y);
+
+    /**
+     * Number of tiles pickSpawnTile can choose from
+     */
+    int64_t getSpawnTileCount();
+
+    /**
+     * Moves the entity onto the given tile, which has to be free
+     */
+    void moveEntity(EntityHandle entity, int x, int y);
 
     /**
      * Completely removes given agent from model
      */
-    void exit(std::shared_ptr<Agent> agent);
+    void exit(EntityHandle agent);
 
     /**
-     * Removes only the visual representation of given wumpus
+     * Removes the given wumpus from its tile and clears the stench around it
      */
-    void removeWumpus(std::shared_ptr<Wumpus> wumpus);
+    void removeWumpus(EntityHandle wumpus);
 
     /**
      * Sets stench at given coordinates
      */
     void setStench(int x, int y);
 
+    /**
+     * Records that the agent stands on the given tile in its knowledge map
+     */
+    void visit(int agentId, int x, int y);
+
+    /**
+     * Returns what the agent with the given ID has visited and perceived in the
+     * current world. Returns null if the agent has never been on the field.
+     */
+    std::shared_ptr<KnowledgeMap> getKnowledge(int agentId);
+
 private:
-    ros::NodeHandle* rosNode;
+    /**
+     * Upper bound of candidates checked by initSolvable
+     */
+    static const int MAX_SOLVABLE_CANDIDATES = 100000;
+
     int playGroundSize;
     int wumpusCount;
     int trapCount;
     bool agentHasArrow;
-    std::vector<std::vector<std::shared_ptr<GroundTile>>> playGround;
-
-    Model();
+    unsigned int seed;
+    bool quiet;
+    PlayGround playGround;
+    std::map<int, std::shared_ptr<KnowledgeMap>> knowledge;
 
     /**
      * Sets breeze at given coordinates
      */
     void setBreeze(int x, int y);
+
+    /**
+     * Converts the tile including the entity standing on it
+     */
+    WorldTile toWorldTile(std::shared_ptr<GroundTile> tile);
+
+    /**
+     * Copies the chunk with the given index, null if it is plain dirt
+     */
+    std::shared_ptr<const RenderSnapshot::Chunk> copyChunk(int index);
+
+    /**
+     * Marks the tiles of the entities that changed since the last call as dirty
+     */
+    void markChangedEntities();
 };
 
 } /* namespace wumpus_simulator */
\ No newline at end of file
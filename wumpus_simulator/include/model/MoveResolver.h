@@ -0,0 +1,140 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "EntityRegistry.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace wumpus_simulator
+{
+class Model;
+
+/**
+ * Move of one wumpus in a tick in which all autonomous wumpus move at the same time
+ */
+struct MoveIntent
+{
+    EntityHandle wumpus;
+    /**
+     * WumpusEnums::heading or WumpusBehaviour::NO_MOVE
+     */
+    int direction;
+    /**
+     * Tile indices x * size + y, target is -1 if the wumpus stays or bumps into the border
+     */
+    int64_t source;
+    int64_t target;
+    /**
+     * Set by the resolver if the wumpus ends up on the target tile
+     */
+    bool moves;
+};
+
+/**
+ * Decides which moves of a tick succeed. Every wumpus picks its move from the state at the
+ * start of the tick, then the moves are resolved as if they were executed one after another
+ * in the given order: a wumpus is blocked if the target still holds a wumpus at its turn.
+ *
+ * Large ticks are spread over worker threads. The playground is split into square regions and
+ * the moves are grouped by the tiles they touch. Groups that stay inside one region are resolved
+ * in parallel, moves across region borders and the groups they share tiles with are resolved
+ * afterwards on the calling thread. Groups never share tiles, so the result is identical to the
+ * serial resolution for every thread count and region size.
+ */
+class MoveResolver
+{
+public:
+    MoveResolver();
+    virtual ~MoveResolver();
+
+    /**
+     * Starts the worker threads, the calling thread always helps
+     * @param threadCount int threads including the caller, 0 uses all cores, 1 resolves serially
+     * @param regionSize int edge length of a region in tiles
+     */
+    void start(int threadCount, int regionSize);
+    void stop();
+
+    /**
+     * Asks the behaviours of the wumpus for their moves and resolves them.
+     * The model must not change while this runs.
+     * @return std::vector<MoveIntent> one intent per wumpus, in the same order
+     */
+    std::vector<MoveIntent> resolve(Model* model, const std::vector<EntityHandle>& wumpus);
+
+private:
+    /**
+     * Below this many wumpus a tick is not worth waking the workers
+     */
+    static const size_t MIN_PARALLEL_MOVES = 256;
+    /**
+     * Number of wumpus a worker asks for its next move at once
+     */
+    static const size_t INTENT_BATCH = 64;
+
+    int regionSize;
+    bool stopping;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable done;
+    /**
+     * Current job, workers take tasks until nextTask passes taskCount
+     */
+    const std::function<void(size_t)>* task;
+    size_t taskCount;
+    std::atomic<size_t> nextTask;
+    int generation;
+    int busyWorkers;
+
+    /**
+     * Runs task(0) to task(count - 1) on all threads and returns when they are done
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+    void runTasks();
+    void work();
+
+    /**
+     * Resolves the intents at the given indices in ascending order against the model
+     */
+    void resolveSerial(Model* model, std::vector<MoveIntent>& intents, const std::vector<uint32_t>& indices);
+
+    /**
+     * Resolves the groups of a region that touch none of the tiles used by moves across
+     * its border and returns the indices of the other intents in deferred
+     */
+    void resolveRegion(Model* model, std::vector<MoveIntent>& intents, const std::vector<uint32_t>& indices,
+            const std::unordered_set<int64_t>& borderTiles, std::vector<uint32_t>& deferred);
+};
+
+} /* namespace wumpus_simulator */
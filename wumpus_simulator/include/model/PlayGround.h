@@ -0,0 +1,158 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "SpawnTiles.h"
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace wumpus_simulator
+{
+class GroundTile;
+
+/**
+ * Sparse, chunked storage of the ground tiles of a square playground.
+ * Chunks and the tiles inside them are only allocated when they are written to,
+ * so that huge worlds which mostly consist of plain dirt fit into memory.
+ */
+class PlayGround
+{
+public:
+    /**
+     * Edge length of a single chunk in tiles
+     */
+    static const int CHUNK_SIZE = 32;
+
+    PlayGround();
+    virtual ~PlayGround();
+
+    /**
+     * Drops all chunks and prepares an empty playground with the given edge length
+     * @param size int edge length of square field
+     */
+    void reset(int size);
+
+    int getSize();
+
+    /**
+     * Returns the tile located at x and y and allocates it if it is untouched.
+     * Use this accessor whenever the tile is going to be modified, the tile is
+     * marked as dirty until the next call of takeDirtyTiles.
+     * @return shared_ptr<GroundTile>
+     */
+    std::shared_ptr<GroundTile> getTile(int x, int y);
+
+    /**
+     * Returns the tile located at x and y without allocating it. Untouched tiles
+     * are represented by a shared plain dirt tile which must not be modified.
+     * @return shared_ptr<GroundTile>
+     */
+    std::shared_ptr<GroundTile> peekTile(int x, int y);
+
+    /**
+     * Marks an allocated tile as dirty without handing it out, e.g. when the entity standing on it turned
+     */
+    void markDirty(int x, int y);
+
+    /**
+     * Returns true if the tile at x and y has been allocated
+     */
+    bool isAllocated(int x, int y);
+
+    /**
+     * Returns all allocated tiles, ordered by chunk and row
+     */
+    std::vector<std::shared_ptr<GroundTile>> getAllocatedTiles();
+
+    /**
+     * Number of chunks that have been allocated so far
+     */
+    int getAllocatedChunkCount();
+
+    /**
+     * Returns the tiles handed out by getTile or marked by markDirty since the last call and clears their dirty mark
+     */
+    std::vector<std::shared_ptr<GroundTile>> takeDirtyTiles();
+
+    /**
+     * Returns the indices of the chunks that had tiles handed out by getTile since the last call
+     */
+    std::vector<int> takeChangedChunks();
+
+    int getChunksPerSide();
+
+    /**
+     * Returns the tiles of the chunk in row-major order, null if the chunk is plain dirt.
+     * Unallocated tiles inside the chunk are null as well.
+     */
+    const std::vector<std::shared_ptr<GroundTile>>* getChunkTiles(int index);
+
+    /**
+     * Number of resets so far. Dirty tiles only describe changes within the same reset.
+     */
+    uint32_t getResetCount();
+
+    /**
+     * Zobrist hash of all tiles, updated by the tiles themselves
+     */
+    uint64_t getHash();
+
+    /**
+     * Tiles agents can be spawned on, updated by the tiles themselves
+     */
+    SpawnTiles& getSpawnTiles();
+
+private:
+    struct Chunk
+    {
+        std::vector<std::shared_ptr<GroundTile>> tiles;
+        bool changed;
+    };
+
+    int size;
+    int chunksPerSide;
+    int allocatedChunks;
+    uint32_t resetCount;
+    uint64_t hash;
+    SpawnTiles spawnTiles;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::shared_ptr<GroundTile> defaultTile;
+    std::vector<std::shared_ptr<GroundTile>> dirtyTiles;
+    std::vector<int> changedChunks;
+
+    /**
+     * Returns the slot of the tile at x and y inside its chunk, allocating the chunk if requested
+     */
+    std::shared_ptr<GroundTile>* findSlot(int x, int y, bool allocate);
+
+    /**
+     * Adds the tile and its chunk to the change lists unless they are already on them
+     */
+    void markChanged(const std::shared_ptr<GroundTile>& tile, int x, int y);
+};
+
+} /* namespace wumpus_simulator */
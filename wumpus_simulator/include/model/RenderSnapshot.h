@@ -0,0 +1,138 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace wumpus_simulator
+{
+
+/**
+ * Counts per block of tiles of a rectangular region, used for zoomed out views.
+ * The vectors hold rows * cols blocks in row-major order.
+ */
+struct Overview
+{
+    int block;
+    int rows;
+    int cols;
+    std::vector<uint32_t> hazards;
+    std::vector<uint32_t> gold;
+    std::vector<uint32_t> agents;
+};
+
+/**
+ * Everything needed to draw a single tile
+ */
+struct RenderCell
+{
+    uint8_t state;
+    uint8_t heading;
+    int32_t agentId;
+};
+
+/**
+ * Immutable copy of the render relevant state of the model. The simulation publishes a
+ * new snapshot after every committed change, readers keep the one they loaded as long
+ * as they need it. Unchanged chunks and pages of the chunk table are shared between
+ * consecutive snapshots, so a snapshot only costs the table spine and the changed pages.
+ */
+class RenderSnapshot
+{
+public:
+    /**
+     * Bits of RenderCell::state
+     */
+    enum stateBits : uint8_t
+    {
+        trap = 1,
+        gold = 2,
+        stench = 4,
+        breeze = 8,
+        startpoint = 16,
+        wumpus = 32,
+        agent = 64
+    };
+
+    /**
+     * Cells of a chunk in the layout of PlayGround, CHUNK_SIZE * CHUNK_SIZE in row-major order
+     */
+    typedef std::vector<RenderCell> Chunk;
+
+    /**
+     * Consecutive chunks of the chunk table, the last page may be shorter
+     */
+    typedef std::vector<std::shared_ptr<const Chunk>> Page;
+
+    /**
+     * Chunks per page
+     */
+    static const int PAGE_CHUNKS = 512;
+
+    /**
+     * Counts the published snapshots, consecutive snapshots of the same world differ by one
+     */
+    uint64_t version;
+
+    /**
+     * PlayGround::getResetCount of the world, a new value means a different world
+     */
+    uint32_t resetCount;
+
+    int playGroundSize;
+    int wumpusCount;
+    int trapCount;
+    bool agentHasArrow;
+    unsigned int seed;
+
+    /**
+     * Chunk table in the order of PlayGround, split into pages of PAGE_CHUNKS chunks
+     */
+    std::vector<std::shared_ptr<const Page>> pages;
+
+    /**
+     * Returns the chunk with the given index, null if it is plain dirt.
+     * The chunk lives as long as the snapshot.
+     */
+    const Chunk* getChunk(int index) const;
+
+    /**
+     * Returns the cell at x and y, which has to be on the playground
+     */
+    RenderCell getCell(int x, int y) const;
+
+    /**
+     * Counts hazards, gold and agents in blocks of block x block tiles of the region
+     * starting at x and y, only looking at chunks that are not plain dirt
+     */
+    Overview getOverview(int x, int y, int rows, int cols, int block) const;
+
+private:
+    int getChunksPerSide() const;
+};
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,83 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <random>
+#include <stdint.h>
+#include <unordered_map>
+
+namespace wumpus_simulator
+{
+/**
+ * Set of the tiles an agent may be spawned on, with O(1) insertion, removal and random pick.
+ * All tiles of the playground are kept in one permutation and the first size() positions
+ * hold the members. The permutation is the identity except for the swapped positions, so
+ * only tiles that changed their membership at some point take memory, even for huge worlds.
+ */
+class SpawnTiles
+{
+public:
+    SpawnTiles();
+    virtual ~SpawnTiles();
+
+    /**
+     * Makes every tile of a square playground with the given edge length a member
+     */
+    void reset(int size);
+
+    void add(int x, int y);
+    void remove(int x, int y);
+    bool contains(int x, int y);
+
+    /**
+     * Number of members
+     */
+    int64_t size();
+
+    /**
+     * Returns a uniformly chosen member
+     * @return false if the set is empty
+     */
+    bool pick(std::minstd_rand& random, int& x, int& y);
+
+private:
+    int edge;
+    int64_t count;
+    /**
+     * Tile at a position and position of a tile, only where they differ from the identity
+     */
+    std::unordered_map<int64_t, int64_t> tiles;
+    std::unordered_map<int64_t, int64_t> positions;
+
+    int64_t getTile(int64_t position);
+    int64_t getPosition(int64_t tile);
+
+    /**
+     * Exchanges the tiles at both positions
+     */
+    void swap(int64_t first, int64_t second);
+};
+
+} /* namespace wumpus_simulator */
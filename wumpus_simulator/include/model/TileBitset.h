@@ -22,50 +22,69 @@
  * SOFTWARE.
  */
 
-#include <model/Agent.h>
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
 
 namespace wumpus_simulator
 {
-
-Agent::Agent(std::shared_ptr<GroundTile> tile)
+/**
+ * Dense bitset over the tiles of a square playground, one bit per tile
+ */
+class TileBitset
 {
-    this->tile = tile;
-    type = "agent";
-    arrow = false;
-    hasGold = false;
-    this->heading = WumpusEnums::heading::up;
-}
+public:
+    TileBitset();
+    TileBitset(int size);
 
-Agent::~Agent() {}
+    /**
+     * Resizes the bitset to the given edge length and clears all bits
+     */
+    void reset(int size);
 
-bool Agent::hasArrow()
-{
-    return arrow;
-}
+    int getSize() const
+    {
+        return size;
+    }
 
-void Agent::setArrow(bool value)
-{
-    this->arrow = value;
-}
+    bool test(int x, int y) const
+    {
+        int64_t index = (int64_t) x * size + y;
+        return (words[index >> 6] >> (index & 63)) & 1;
+    }
 
-WumpusEnums::heading Agent::getHeading()
-{
-    return heading;
-}
+    void set(int x, int y)
+    {
+        int64_t index = (int64_t) x * size + y;
+        words[index >> 6] |= (uint64_t) 1 << (index & 63);
+    }
 
-void Agent::setHeading(WumpusEnums::heading heading)
-{
-    this->heading = heading;
-}
+    void clear(int x, int y)
+    {
+        int64_t index = (int64_t) x * size + y;
+        words[index >> 6] &= ~((uint64_t) 1 << (index & 63));
+    }
 
-void wumpus_simulator::Agent::setHasGold(bool value)
-{
-    this->hasGold = value;
-}
+    /**
+     * Clears all bits without releasing memory
+     */
+    void clearAll();
 
-bool wumpus_simulator::Agent::getHasGold()
-{
-    return hasGold;
-}
+    /**
+     * Number of set bits
+     */
+    int count() const;
+
+    /**
+     * Memory used by the bits in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    int size;
+    std::vector<uint64_t> words;
+};
 
 } /* namespace wumpus_simulator */
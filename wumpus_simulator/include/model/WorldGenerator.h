@@ -0,0 +1,102 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace wumpus_simulator
+{
+
+/**
+ * Positions of everything that is randomly placed when a world is created
+ */
+struct WorldLayout
+{
+    unsigned int seed;
+    int playGroundSize;
+    std::vector<std::pair<int, int>> traps;
+    std::vector<std::pair<int, int>> wumpus;
+    std::pair<int, int> gold;
+};
+
+/**
+ * Creates random world layouts. Every layout is completely determined by its seed,
+ * so candidates can be generated on several threads at once.
+ */
+class WorldGenerator
+{
+public:
+    /**
+     * @param wumpusCount int the number of wumpus that will be spawned
+     * @param trapCount int the number of traps that will be spawned
+     * @param playGroundSize int edge length of square field
+     */
+    WorldGenerator(int wumpusCount, int trapCount, int playGroundSize);
+    virtual ~WorldGenerator();
+
+    /**
+     * Places traps, wumpus and gold at random
+     * @param seed unsigned int seed of the random number generator
+     */
+    WorldLayout generate(unsigned int seed);
+
+    /**
+     * Checks if the gold can be reached from at least one possible start tile
+     * without entering a trap or a wumpus.
+     */
+    bool isSolvable(const WorldLayout& layout);
+
+    /**
+     * Length of the shortest safe path from the closest possible start tile to the gold,
+     * -1 if the gold cannot be reached. Does a flood fill on bitsets starting at the gold.
+     */
+    int getGoldDistance(const WorldLayout& layout);
+
+    /**
+     * Generates candidates for the seeds seed, seed + 1, ... in parallel until one is solvable.
+     * Always returns the solvable candidate with the lowest seed, independent of the thread count.
+     * If no candidate passes within maxCandidates, the first candidate is returned.
+     * @param threadCount int number of worker threads, 0 uses all cores
+     */
+    WorldLayout generateSolvable(unsigned int seed, int threadCount, int maxCandidates);
+
+    /**
+     * Statistics of the last call to generateSolvable
+     */
+    int getCandidateCount();
+    int getSolvableCount();
+    double getCandidatesPerSecond();
+
+private:
+    int wumpusCount;
+    int trapCount;
+    int playGroundSize;
+    int candidateCount;
+    int solvableCount;
+    double candidatesPerSecond;
+};
+
+} /* namespace wumpus_simulator */
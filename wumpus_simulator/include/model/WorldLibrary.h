@@ -0,0 +1,131 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace wumpus_simulator
+{
+
+/**
+ * One tile of a world file that is not plain dirt
+ */
+struct WorldTile
+{
+    int x;
+    int y;
+    bool trap;
+    bool gold;
+    bool stench;
+    bool breeze;
+    bool startpoint;
+    int startAgentID;
+    /**
+     * EntityRegistry::kind of the movable on the tile
+     */
+    uint8_t entity;
+    int agentId;
+    int agentHeading;
+    bool agentHasGold;
+    bool agentHasArrow;
+};
+
+/**
+ * Decoded content of a wumpus world file, ready to be applied by Model::fromRecord
+ */
+struct WorldRecord
+{
+    std::string id;
+    bool agentHasArrow;
+    int playGroundSize;
+    int wumpusCount;
+    int trapCount;
+    unsigned int seed;
+    std::vector<WorldTile> tiles;
+};
+
+/**
+ * Cache of decoded world files. Files are memory-mapped and parsed once, switching
+ * to a cached world afterwards neither touches the disk nor parses JSON.
+ * Worlds are found by path or by ID, the file name without extension.
+ */
+class WorldLibrary
+{
+public:
+    WorldLibrary();
+    virtual ~WorldLibrary();
+
+    /**
+     * Decodes the JSON written by Model::toJSON
+     */
+    static WorldRecord parse(const QJsonObject& root);
+
+    /**
+     * Encodes the world in the format of Model::toJSON, plain dirt tiles are left out
+     */
+    static QJsonObject serialize(const WorldRecord& world);
+
+    /**
+     * Loads all worlds of a directory (*.wwf) or of an index.json written by wumpus_world_generator.
+     * Worlds that are already cached are not read again.
+     * @return one key for get() per loaded entry in the order of the directory or index, the ID or
+     * the path if another file already took the ID. Repeated entries are returned repeatedly.
+     */
+    std::vector<std::string> preload(const QString& path);
+
+    /**
+     * Returns the world with the given ID or path, reading and caching the file if it is not known yet.
+     * Returns null if the world cannot be found.
+     */
+    std::shared_ptr<const WorldRecord> get(const std::string& world);
+
+    /**
+     * IDs in the order the worlds were added
+     */
+    std::vector<std::string> getIds();
+
+    size_t size();
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<const WorldRecord>> byId;
+    std::map<std::string, std::shared_ptr<const WorldRecord>> byPath;
+    std::vector<std::string> ids;
+
+    /**
+     * Maps, parses and caches the file, the lock has to be held
+     */
+    std::shared_ptr<const WorldRecord> read(const QString& path);
+};
+
+} /* namespace wumpus_simulator */
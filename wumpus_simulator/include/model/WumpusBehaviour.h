@@ -0,0 +1,111 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "EntityRegistry.h"
+#include "WumpusEnums.h"
+
+#include <memory>
+#include <random>
+#include <string>
+
+namespace wumpus_simulator
+{
+class Model;
+
+/**
+ * Strategy for a wumpus that is moved by the simulator itself instead of an external node
+ */
+class WumpusBehaviour
+{
+public:
+    /**
+     * Returned by nextMove if the wumpus should stay where it is
+     */
+    static const int NO_MOVE = -1;
+
+    virtual ~WumpusBehaviour();
+
+    /**
+     * Creates a behaviour by name: "random", "chase" or "patrol".
+     * Returns null for "static" and unknown names.
+     * @param seed unsigned int seed for behaviours that need random numbers
+     */
+    static std::shared_ptr<WumpusBehaviour> create(const std::string& name, unsigned int seed);
+
+    /**
+     * Decides in which direction the wumpus moves next
+     * @return int a WumpusEnums::heading or NO_MOVE
+     */
+    virtual int nextMove(EntityHandle wumpus, Model* model) = 0;
+
+    /**
+     * Moves the coordinates one tile into the given direction
+     */
+    static void step(int direction, int& x, int& y);
+
+protected:
+    /**
+     * True if the tile exists and contains neither a trap nor another wumpus
+     */
+    static bool isFree(Model* model, int x, int y);
+};
+
+/**
+ * Moves into a random free direction every turn cycle
+ */
+class RandomWalkBehaviour : public WumpusBehaviour
+{
+public:
+    RandomWalkBehaviour(unsigned int seed);
+    int nextMove(EntityHandle wumpus, Model* model);
+
+private:
+    std::minstd_rand random;
+};
+
+/**
+ * Moves towards the agent with the lowest manhattan distance
+ */
+class ChaseBehaviour : public WumpusBehaviour
+{
+public:
+    int nextMove(EntityHandle wumpus, Model* model);
+};
+
+/**
+ * Walks straight ahead and turns around when it cannot go any further
+ */
+class PatrolBehaviour : public WumpusBehaviour
+{
+public:
+    PatrolBehaviour(WumpusEnums::heading heading);
+    int nextMove(EntityHandle wumpus, Model* model);
+
+private:
+    WumpusEnums::heading heading;
+};
+
+} /* namespace wumpus_simulator */
@@ -60,7 +60,9 @@ public:
         dead,
         otherAgent,
         killedAgent,
-        yourTurn
+        yourTurn,
+        timedOut,
+        evicted
     };
 
     /**
@@ -73,4 +75,22 @@ public:
         down,
         right
     };
+
+    /**
+     * Change of x for one step into the given heading, shared by the movement of agents and wumpus
+     */
+    static int stepX(int heading)
+    {
+        static const int steps[4] = {-1, 0, 1, 0};
+        return steps[heading];
+    }
+
+    /**
+     * Change of y for one step into the given heading
+     */
+    static int stepY(int heading)
+    {
+        static const int steps[4] = {0, -1, 0, 1};
+        return steps[heading];
+    }
 };
@@ -24,22 +24,51 @@
 
 #pragma once
 
-#include <model/Movable.h>
-
-#include <memory>
+#include <stdint.h>
 
 namespace wumpus_simulator
 {
-class GroundTile;
-
 /**
- * Class representing the wumpus. Can be controlled from outside the simulator
+ * Keys of the Zobrist hash of the world state. The keys are derived from location,
+ * feature and value by a mixing function instead of being stored in a table, so
+ * they need no memory even for huge worlds and are the same in every process.
  */
-class Wumpus : public Movable
+namespace Zobrist
 {
-public:
-    Wumpus(std::shared_ptr<GroundTile> tile);
-    virtual ~Wumpus();
+enum feature : uint64_t
+{
+    trap = 1,
+    gold,
+    stench,
+    breeze,
+    startpoint,
+    startAgentID,
+    tileEntity,
+    entity
 };
 
+/**
+ * Finalizer of splitmix64
+ */
+inline uint64_t mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @param location tile (x << 32 | y) or entity (kind << 32 | id)
+ */
+inline uint64_t key(uint64_t location, feature type, uint64_t value = 1)
+{
+    return mix(location + 0x9e3779b97f4a7c15ULL * mix(((uint64_t) type << 48) ^ value));
+}
+
+inline uint64_t tileLocation(int x, int y)
+{
+    return ((uint64_t)(uint32_t) x << 32) | (uint32_t) y;
+}
+} /* namespace Zobrist */
+
 } /* namespace wumpus_simulator */
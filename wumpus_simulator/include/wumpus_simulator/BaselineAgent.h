@@ -0,0 +1,146 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <wumpus_simulator/ActionResponse.h>
+#include <wumpus_simulator/InitialPoseResponse.h>
+
+#include <memory>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+namespace wumpus_simulator
+{
+/**
+ * Reference agent that runs inside the simulator process. It only knows what an
+ * external agent would learn from its spawn and action responses.
+ */
+class BaselineAgent
+{
+public:
+    /**
+     * Returned by nextAction if the agent has nothing to do
+     */
+    static const int NO_ACTION = -1;
+
+    BaselineAgent();
+    virtual ~BaselineAgent();
+
+    /**
+     * Creates an agent by name: "random" or "explorer". Returns null for unknown names.
+     * @param seed unsigned int seed for agents that need random numbers
+     */
+    static std::unique_ptr<BaselineAgent> create(const std::string& name, unsigned int seed);
+
+    /**
+     * Starts a new episode at the spawn position
+     */
+    virtual void spawn(const InitialPoseResponse& pose);
+
+    /**
+     * Updates position, heading, gold and percepts from a response addressed to this agent
+     */
+    virtual void perceive(const ActionResponse& response);
+
+    /**
+     * Decides the next action once the agent has its turn
+     * @return int a WumpusEnums::actions or NO_ACTION
+     */
+    virtual int nextAction() = 0;
+
+    bool isAlive();
+
+protected:
+    int size;
+    int x;
+    int y;
+    int heading;
+    int startX;
+    int startY;
+    bool hasArrow;
+    bool hasGold;
+    bool alive;
+    /**
+     * Set if the last move was blocked by another agent
+     */
+    bool blocked;
+    bool shiny;
+    bool drafty;
+    bool stinky;
+
+    /**
+     * Action that turns the agent towards the given heading or moves if it already faces it
+     */
+    int walk(int direction);
+};
+
+/**
+ * Picks up gold it stands on and otherwise wanders around randomly without bumping into walls
+ */
+class RandomAgent : public BaselineAgent
+{
+public:
+    RandomAgent(unsigned int seed);
+    int nextAction();
+
+private:
+    std::minstd_rand random;
+};
+
+/**
+ * Only enters tiles that are proven safe: the start tile and the neighbours of tiles
+ * without breeze and stench. Walks back to the start with the gold and leaves. If no
+ * safe tile is left, it risks the nearest unexplored tile next to the explored area.
+ */
+class ExplorerAgent : public BaselineAgent
+{
+public:
+    void spawn(const InitialPoseResponse& pose);
+    void perceive(const ActionResponse& response);
+    int nextAction();
+
+private:
+    enum knowledge : uint8_t
+    {
+        safe = 1,
+        visited = 2
+    };
+
+    /**
+     * Known tiles by x * size + y, only tiles next to the visited ones are stored
+     */
+    std::unordered_map<int64_t, uint8_t> known;
+
+    /**
+     * First heading of a shortest path over safe tiles to the nearest tile that satisfies goal, -1 if there is none.
+     * The goal itself does not need to be safe.
+     */
+    template <typename Goal>
+    int findPath(Goal goal);
+};
+
+} /* namespace wumpus_simulator */
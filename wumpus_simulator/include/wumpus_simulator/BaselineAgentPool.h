@@ -0,0 +1,121 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <wumpus_simulator/ActionRequest.h>
+#include <wumpus_simulator/ActionResponse.h>
+#include <wumpus_simulator/BaselineAgent.h>
+#include <wumpus_simulator/InitialPoseResponse.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wumpus_simulator
+{
+/**
+ * Runs the baseline agents on a small pool of worker threads. Every agent has an inbox
+ * of spawn poses and responses that is processed by one worker at a time, so an agent
+ * sees its messages in order without locking on its own. Actions are handed to the
+ * callback directly instead of being published on /wumpus_simulator/ActionRequest.
+ */
+class BaselineAgentPool
+{
+public:
+    typedef std::function<void(ActionRequestPtr)> ActionCallback;
+
+    BaselineAgentPool();
+    virtual ~BaselineAgentPool();
+
+    /**
+     * Adds an agent, only allowed before start
+     */
+    void add(int id, std::unique_ptr<BaselineAgent> agent);
+
+    /**
+     * Starts the workers, does nothing without agents
+     * @param threads number of workers, 0 uses one per core
+     * @param callback receives the actions of the agents, it is called without any lock of the pool held
+     */
+    void start(int threads, ActionCallback callback);
+
+    /**
+     * Stops and joins the workers, must not be called while the callback is blocked by the caller
+     */
+    void stop();
+
+    bool contains(int id);
+
+    bool empty();
+
+    std::vector<int> getIds();
+
+    /**
+     * Queues a new episode for the agent with the id of the pose
+     */
+    void spawn(const InitialPoseResponse& pose);
+
+    /**
+     * Queues a response for the agent with the id of the response
+     */
+    void deliver(const ActionResponse& response);
+
+private:
+    struct Event
+    {
+        bool spawn;
+        InitialPoseResponse pose;
+        ActionResponse response;
+    };
+
+    struct Slot
+    {
+        std::unique_ptr<BaselineAgent> agent;
+        std::deque<Event> inbox;
+        /**
+         * Set while the agent is waiting in ready or being processed by a worker
+         */
+        bool scheduled;
+    };
+
+    std::map<int, Slot> agents;
+    std::deque<int> ready;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping;
+    ActionCallback callback;
+
+    void enqueue(int id, Event&& event);
+    void run();
+    static bool isTurn(const ActionResponse& response);
+};
+
+} /* namespace wumpus_simulator */
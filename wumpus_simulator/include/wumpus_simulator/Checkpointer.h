@@ -0,0 +1,107 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <model/WorldLibrary.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wumpus_simulator
+{
+/**
+ * Writes periodic checkpoints of the running simulation on a background thread.
+ * The simulation thread only hands over the tiles that changed since the previous
+ * checkpoint, the worker keeps the complete image of the world, serializes it and
+ * replaces the checkpoint file atomically after an fsync.
+ */
+class Checkpointer
+{
+public:
+    Checkpointer();
+    virtual ~Checkpointer();
+
+    /**
+     * Starts the worker, an empty path disables checkpoints
+     */
+    void configure(const std::string& path);
+
+    bool isEnabled();
+
+    const std::string& getPath();
+
+    /**
+     * Adds changes to the next checkpoint. Changes that were not written yet are merged.
+     * @param resetCount result of Model::takeChanges, a new value replaces the image of the worker
+     * @param changes tiles changed since the previous call
+     */
+    void add(uint32_t resetCount, WorldRecord&& changes);
+
+    /**
+     * Queues a checkpoint of the added changes and returns immediately
+     */
+    void submit(const std::vector<int>& turns, int turnIndex);
+
+    /**
+     * Reads a checkpoint written by this class
+     * @return false if the file is missing or no checkpoint
+     */
+    static bool read(const std::string& path, WorldRecord& world, std::vector<int>& turns, int& turnIndex);
+
+private:
+    struct Pending
+    {
+        uint32_t resetCount;
+        WorldRecord changes;
+        std::vector<int> turns;
+        int turnIndex;
+    };
+
+    std::string path;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping;
+    bool hasPending;
+    Pending pending;
+
+    // Only used by the worker
+    uint32_t imageResetCount;
+    std::map<int64_t, WorldTile> image;
+
+    void run();
+
+    /**
+     * Applies the changes to the image and writes the checkpoint file
+     */
+    bool write(Pending& checkpoint);
+};
+
+} /* namespace wumpus_simulator */
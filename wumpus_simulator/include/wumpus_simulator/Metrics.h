@@ -0,0 +1,119 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+namespace wumpus_simulator
+{
+/**
+ * Lock-free counters and gauges describing the health of the simulator.
+ * Updated from the hot paths, read by the periodic exporters.
+ */
+class Metrics
+{
+public:
+    /**
+     * Monotonically increasing values
+     */
+    enum counter
+    {
+        actions,
+        rejectedActions,
+        spawns,
+        deaths,
+        exits,
+        killedWumpus,
+        timeouts,
+        evictions,
+        renders,
+        renderMicros,
+        COUNTER_COUNT
+    };
+
+    /**
+     * Values that go up and down
+     */
+    enum gauge
+    {
+        liveAgents,
+        liveWumpus,
+        pendingActions,
+        lastRenderMicros,
+        GAUGE_COUNT
+    };
+
+    /**
+     * Returns metrics singleton
+     * @return Metrics*
+     */
+    static Metrics* get();
+
+    void increment(counter c, uint64_t value = 1)
+    {
+        counters[c].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void set(gauge g, int64_t value)
+    {
+        gauges[g].store(value, std::memory_order_relaxed);
+    }
+
+    void add(gauge g, int64_t delta)
+    {
+        gauges[g].fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    uint64_t get(counter c)
+    {
+        return counters[c].load(std::memory_order_relaxed);
+    }
+
+    int64_t get(gauge g)
+    {
+        return gauges[g].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Serializes all values in the Prometheus text exposition format
+     */
+    std::string toPrometheus();
+
+    /**
+     * Writes toPrometheus() to the given file. The file is replaced atomically,
+     * so scrapers never see a partially written file.
+     */
+    bool writePrometheus(const std::string& path);
+
+private:
+    Metrics();
+
+    std::atomic<uint64_t> counters[COUNTER_COUNT];
+    std::atomic<int64_t> gauges[GAUGE_COUNT];
+};
+
+} /* namespace wumpus_simulator */
@@ -24,33 +24,31 @@
 
 #pragma once
 
-#include "Movable.h"
-#include "WumpusEnums.h"
-
-#include <memory>
-
 namespace wumpus_simulator
 {
 /**
- * Agent interacting with the simulator
+ * Compile-time description of the rules a world is played with. The action handlers
+ * of the simulator are instantiated once per rule set, so rules that are switched
+ * off cost nothing per action. The simulator picks the instantiation whenever a
+ * world is created or loaded.
  */
-class Agent : public Movable
+template <bool arrow, bool autonomousWumpus>
+struct RuleSet
 {
-public:
-    Agent(std::shared_ptr<GroundTile> tile);
-    virtual ~Agent();
-
-    bool hasArrow();
-    void setArrow(bool value);
-    WumpusEnums::heading getHeading();
-    void setHeading(WumpusEnums::heading heading);
-    void setHasGold(bool value);
-    bool getHasGold();
-
-private:
-    bool arrow;
-    bool hasGold;
-    WumpusEnums::heading heading;
+    /**
+     * Agents may shoot their arrow
+     */
+    static const bool ARROW = arrow;
+
+    /**
+     * Unpossessed wumpus move on their own once per turn cycle
+     */
+    static const bool AUTONOMOUS_WUMPUS = autonomousWumpus;
 };
 
+/**
+ * Rules of a world created from the web interface with the default parameters
+ */
+typedef RuleSet<true, false> ClassicRules;
+
 } /* namespace wumpus_simulator */
@@ -0,0 +1,166 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace wumpus_simulator
+{
+/**
+ * Aggregates per-agent statistics while actions are applied and writes them
+ * in bulk once an episode is over. An episode starts with a new world and
+ * ends when every agent that was spawned has exited, died or been evicted.
+ */
+class ScoreBoard
+{
+public:
+    /**
+     * How an agent left the episode
+     */
+    enum outcome
+    {
+        playing,
+        exited,
+        trap,
+        eaten,
+        evicted,
+        aborted
+    };
+
+    /**
+     * One row of the results, one per agent and episode.
+     * The binary format is a sequence of these structs in native byte order.
+     */
+    struct Record
+    {
+        uint32_t episode;
+        uint32_t seed;
+        int32_t playGroundSize;
+        int32_t wumpusCount;
+        int32_t trapCount;
+        int32_t agentId;
+        uint32_t turns;
+        uint32_t steps;
+        uint32_t bumps;
+        uint32_t rotations;
+        uint32_t arrowsShot;
+        uint32_t wumpusKilled;
+        uint32_t timeouts;
+        uint8_t hasGold;
+        uint8_t outcome;
+        uint16_t reserved;
+        uint64_t agentMicros;
+        uint64_t episodeMicros;
+    };
+
+    ScoreBoard();
+    virtual ~ScoreBoard();
+
+    /**
+     * Configures the result file, an empty path disables the export
+     * @param format "csv" or "binary"
+     * @param flushEpisodes number of finished episodes buffered before they are written
+     */
+    void configure(const std::string& path, const std::string& format, int flushEpisodes);
+
+    /**
+     * Starts a new episode on the given world, aborting agents of the previous one that are still playing
+     */
+    void beginEpisode(uint32_t seed, int playGroundSize, int wumpusCount, int trapCount);
+
+    void spawn(int agentId);
+    void turn(int agentId);
+    void step(int agentId);
+    void bump(int agentId);
+    void rotate(int agentId);
+    void shot(int agentId);
+    void kill(int agentId);
+    void gold(int agentId);
+    void timeout(int agentId);
+
+    /**
+     * Records how the agent left the episode
+     * @return true if this finished the episode
+     */
+    bool finish(int agentId, outcome result);
+
+    /**
+     * True if the last agent of the episode finished and nobody spawned since
+     */
+    bool isEpisodeOver();
+
+    /**
+     * Number of finished episodes
+     */
+    uint32_t getEpisodeCount();
+
+    /**
+     * Writes all buffered records to the result file
+     */
+    bool flush();
+
+    static const char* getOutcomeName(uint8_t result);
+
+private:
+    struct AgentState
+    {
+        Record record;
+        uint64_t spawnMicros;
+    };
+
+    std::string path;
+    bool binary;
+    int flushEpisodes;
+
+    Record world;
+    uint32_t episodeCount;
+    uint64_t episodeStartMicros;
+    int playingCount;
+    bool over;
+    std::map<int, AgentState> agents;
+    /**
+     * Earlier lives of agents that respawned in the current episode
+     */
+    std::vector<Record> finished;
+
+    std::vector<Record> pending;
+    int pendingEpisodes;
+
+    /**
+     * Returns the state of a playing agent or nullptr
+     */
+    AgentState* getAgent(int agentId);
+
+    void endEpisode();
+    bool writeCSV();
+    bool writeBinary();
+
+    static uint64_t nowMicros();
+};
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,137 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace wumpus_simulator
+{
+/**
+ * Records timed spans into an in-memory ring buffer and writes them as
+ * Chrome trace-event JSON. Recording is disabled by default and then only
+ * costs a relaxed atomic load per span.
+ */
+class Tracer
+{
+public:
+    /**
+     * Returns tracer singleton
+     * @return Tracer*
+     */
+    static Tracer* get();
+
+    /**
+     * Starts recording, keeping the latest capacity spans
+     */
+    void enable(size_t capacity);
+    void disable();
+
+    bool isEnabled()
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Stores a finished span. The name has to be a string literal.
+     */
+    void record(const char* name, uint64_t startMicros, uint64_t endMicros);
+
+    /**
+     * Writes all buffered spans as Chrome trace-event JSON to the given file
+     */
+    bool flush(const std::string& path);
+
+    /**
+     * Monotonic time stamp in microseconds
+     */
+    static uint64_t nowMicros();
+
+private:
+    struct Event
+    {
+        /**
+         * Index of the record call that last wrote this slot plus one, 0 while being written
+         */
+        std::atomic<uint64_t> sequence;
+        const char* name;
+        uint64_t start;
+        uint64_t duration;
+        int threadId;
+    };
+
+    Tracer();
+
+    std::atomic<bool> enabled;
+    std::atomic<uint64_t> next;
+    size_t capacity;
+    std::unique_ptr<Event[]> events;
+
+    /**
+     * Small sequential id of the calling thread
+     */
+    static int currentThreadId();
+};
+
+/**
+ * Records a span from construction to destruction if the tracer is enabled
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char* name)
+    {
+        this->name = name;
+        this->start = Tracer::get()->isEnabled() ? Tracer::nowMicros() : 0;
+    }
+
+    ~TraceScope()
+    {
+        if (this->start != 0) {
+            Tracer::get()->record(this->name, this->start, Tracer::nowMicros());
+        }
+    }
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+} /* namespace wumpus_simulator */
+
+#define WUMPUS_TRACE_CONCAT_INNER(a, b) a##b
+#define WUMPUS_TRACE_CONCAT(a, b) WUMPUS_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * Traces the enclosing scope. Compiled out completely with -DWUMPUS_DISABLE_TRACING.
+ */
+#ifdef WUMPUS_DISABLE_TRACING
+#define WUMPUS_TRACE(name)
+#else
+#define WUMPUS_TRACE(name) wumpus_simulator::TraceScope WUMPUS_TRACE_CONCAT(traceScope, __LINE__)(name)
+#endif
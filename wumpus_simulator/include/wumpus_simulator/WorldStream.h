@@ -0,0 +1,95 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <wumpus_simulator/WorldDelta.h>
+
+#include <model/WorldLibrary.h>
+
+#include <stdint.h>
+
+namespace wumpus_simulator
+{
+/**
+ * Encodes changes of the world as run-length encoded WorldDelta messages, so that
+ * viewers in other processes can follow a match without slowing down the simulation.
+ * Keyframes are sent for every new world, periodically and after the stream was idle.
+ */
+class WorldStream
+{
+public:
+    /**
+     * Bits of the state of a tile in WorldDelta::runState
+     */
+    enum stateBits
+    {
+        trapBit = 1,
+        goldBit = 2,
+        stenchBit = 4,
+        breezeBit = 8,
+        startpointBit = 16,
+        wumpusBit = 32,
+        agentBit = 64
+    };
+
+    WorldStream();
+    virtual ~WorldStream();
+
+    /**
+     * @param keyframeInterval messages between two keyframes, 0 sends keyframes only for new worlds
+     */
+    void configure(bool enabled, int keyframeInterval);
+
+    bool isEnabled();
+
+    /**
+     * True if the next message has to describe the whole world
+     * @param resetCount result of Model::takeChanges
+     */
+    bool needsKeyframe(uint32_t resetCount);
+
+    /**
+     * Makes the next message a keyframe, e.g. because changes were dropped while nobody listened
+     */
+    void requestKeyframe();
+
+    /**
+     * Encodes the tiles of the record into the message
+     * @param keyframe true if the record contains all tiles of the world
+     */
+    void encode(uint32_t resetCount, const WorldRecord& world, bool keyframe, WorldDelta& msg);
+
+    static uint8_t getState(const WorldTile& tile);
+
+private:
+    bool enabled;
+    int keyframeInterval;
+    int sinceKeyframe;
+    bool keyframeRequested;
+    uint32_t lastResetCount;
+    uint32_t sequence;
+};
+
+} /* namespace wumpus_simulator */
@@ -27,8 +27,16 @@
 #include <ui_mainwindow_webview.h>
 #include <wumpus_simulator/ActionRequest.h>
 #include <wumpus_simulator/ActionResponse.h>
+#include <wumpus_simulator/BaselineAgentPool.h>
+#include <wumpus_simulator/Checkpointer.h>
 #include <wumpus_simulator/InitialPoseRequest.h>
 #include <wumpus_simulator/InitialPoseResponse.h>
+#include <wumpus_simulator/LoadWorld.h>
+#include <wumpus_simulator/ScoreBoard.h>
+#include <wumpus_simulator/SimulatorStats.h>
+#include <wumpus_simulator/SpawnAgentsRequest.h>
+#include <wumpus_simulator/SpawnAgentsResponse.h>
+#include <wumpus_simulator/WorldStream.h>
 
 #include <QDialog>
 #include <QTimer>
@@ -37,19 +45,26 @@
 #include <QtNetwork/qnetworkreply.h>
 #include <QtWebKitWidgets/qwebview.h>
 
+#include <model/EntityRegistry.h>
+#include <model/MoveResolver.h>
+#include <model/RenderSnapshot.h>
+#include <model/WorldLibrary.h>
+
 #include <ros/macros.h>
 #include <ros/ros.h>
 #include <rqt_gui_cpp/plugin.h>
+#include <std_msgs/Empty.h>
 
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
 
 namespace wumpus_simulator
 {
 
 class Model;
 class GroundTile;
-class Agent;
-class Wumpus;
 
 /**
  * Handles interactions with agent and wumpus.
@@ -87,8 +102,43 @@ public:
      */
     Q_INVOKABLE void loadWorld();
 
+    /**
+     * Replaces the model with a world of the library without any dialog
+     * @param world string ID of a preloaded world or path of a wwf file
+     * @return false if the world cannot be found
+     */
+    bool openWorld(const std::string& world);
+
+    /**
+     * Restores world, turn order and current turn from a checkpoint and announces the current turn
+     * @return false if the file is no checkpoint
+     */
+    bool resumeCheckpoint(const std::string& path);
+
+    /**
+     * Returns the tiles the agent has visited and perceived as JSON string
+     * {"agentId": id, "visitedCount": n, "perceivedCount": n, "visited": [[x, y], ...], "perceived": [[x, y], ...]}
+     */
+    Q_INVOKABLE QString getKnowledge(int agentId);
+
+    /**
+     * Sets the tiles visible in the web view and redraws them
+     * @param row int first visible row
+     * @param col int first visible column
+     * @param rows int number of visible rows
+     * @param cols int number of visible columns
+     * @param block int tiles per overview cell, 0 draws single tiles
+     */
+    Q_INVOKABLE void setViewport(int row, int col, int rows, int cols, int block);
+
     Model* getModel();
 
+    /**
+     * Latest published state of the world for readers outside of the simulation, e.g. the
+     * web view. Never waits for the simulation, null until the first world is ready.
+     */
+    std::shared_ptr<const RenderSnapshot> getSnapshot();
+
     QWidget* widget_;
     Ui::MainWindowWebView mainwindow;
 
@@ -97,10 +147,17 @@ public:
     ros::AsyncSpinner* spinner;
 
     ros::Subscriber spawnAgentSub;
+    ros::Subscriber spawnAgentsSub;
     ros::Subscriber actionSub;
+    ros::Subscriber flushTraceSub;
+
+    ros::ServiceServer loadWorldService;
 
     ros::Publisher spawnAgentPub;
+    ros::Publisher spawnAgentsPub;
     ros::Publisher actionPub;
+    ros::Publisher statsPub;
+    ros::Publisher deltaPub;
 
 public slots:
     /**
@@ -113,6 +170,11 @@ public slots:
      */
     void callUpdatePlayground();
 
+    /**
+     * Redraw info bar and grid, e.g. after the size of the world changed
+     */
+    void callRedrawWorld();
+
 private:
     Model* model;
     bool ready;
@@ -120,15 +182,196 @@ private:
     std::vector<int> turns;
 
     /**
-     * Colors playground according to model
+     * Instantiations of the rule set of the current world, see selectRules
+     */
+    void (WumpusSimulator::*actionHandler)(ActionRequestPtr msg);
+    void (WumpusSimulator::*nextTurnHandler)();
+
+    /**
+     * Serializes ROS callbacks that change the simulation
+     */
+    std::mutex simulationMutex;
+
+    /**
+     * Replaced as a whole by publishSnapshot, only accessed with std::atomic_load and std::atomic_store
+     */
+    std::shared_ptr<const RenderSnapshot> snapshot;
+
+    // Turn deadline
+    ros::WallTimer turnTimer;
+    ros::WallTime turnStart;
+    /**
+     * True while the current turn waits for an action
+     */
+    bool turnDeadlineArmed;
+    /**
+     * Times the deadline timer checks the current turn per turn timeout
+     */
+    static const int TURN_DEADLINE_CHECKS = 10;
+    double turnTimeout;
+    int timeoutPenalty;
+    int maxTimeouts;
+    std::map<int, int> consecutiveTimeouts;
+    std::map<int, int> penaltyTurns;
+
+    // Metrics export
+    ros::WallTimer metricsTimer;
+    std::string metricsFile;
+    uint64_t lastMetricsActions;
+    ros::WallTime lastMetricsTime;
+
+    // Periodic checkpoints
+    Checkpointer checkpoints;
+    ros::WallTimer checkpointTimer;
+
+    // World delta stream for viewers in other processes
+    WorldStream worldStream;
+    ros::WallTimer deltaTimer;
+
+    /**
+     * Reference agents running in this process, they bypass the ROS topics
+     */
+    BaselineAgentPool baselineAgents;
+
+    /**
+     * Resolves the simultaneous moves of the autonomous wumpus, on several threads for large worlds
+     */
+    MoveResolver wumpusMoves;
+
+    /**
+     * File the recorded trace is written to
+     */
+    std::string traceFile;
+
+    /**
+     * Per-agent and per-episode results
+     */
+    ScoreBoard scores;
+
+    // Response extras
+    /**
+     * Attach the world hash to every action response
+     */
+    bool hashResponses;
+
+    /**
+     * Attach the legal actions to every yourTurn
+     */
+    bool legalActionMasks;
+
+    // Automatic episode reset
+    bool autoReset;
+    int autoResetEpisodes;
+    std::vector<std::string> resetWorlds;
+    size_t nextResetWorld;
+    bool hasResetSeeds;
+    unsigned int nextResetSeed;
+    unsigned int lastResetSeed;
+
+    /**
+     * Agents and wumpus that requested a spawn, respawned on every reset
+     */
+    std::vector<int> registered;
+
+    /**
+     * Chooses spawn tiles, seeded with the seed of the world
+     */
+    std::minstd_rand spawnRandom;
+
+    // Visible part of the playground, see setViewport
+    int viewRow;
+    int viewCol;
+    int viewRows;
+    int viewCols;
+    int overviewBlock;
+
+    /**
+     * Edge length of the region drawn before the web view reported its viewport
+     */
+    static const int DEFAULT_VIEW_SIZE = 32;
+
+    /**
+     * Colors the visible tiles of the playground according to the latest snapshot
      */
     void updatePlayground();
 
+    /**
+     * Sends the hazard and agent density of the region to the overview of the web view
+     */
+    void updateOverview(const RenderSnapshot& snapshot, int row, int col, int rows, int cols);
+
+    /**
+     * Publishes the committed changes as a new snapshot and signals the web view to draw it,
+     * the simulation has to be locked
+     */
+    void publishSnapshot();
+
+    /**
+     * Updates the info bar, redraws the grid and colors it
+     */
+    void redrawWorld();
+
+    /**
+     * Decoded world files, preloaded from /wumpus_simulator/world_library and the reset index
+     */
+    WorldLibrary worlds;
+
+    /**
+     * Starts a fresh episode on the world that was just put into the model
+     */
+    void prepareWorld();
+
+    /**
+     * Hands the changes since the last checkpoint to the checkpoint worker, the simulation has to be locked
+     */
+    void takeCheckpoint();
+
+    void onCheckpointTimer(const ros::WallTimerEvent& event);
+
+    /**
+     * Takes the changes of the model since the last call and hands them to the delta stream
+     * and the next checkpoint, the simulation has to be locked
+     */
+    void collectChanges();
+
+    /**
+     * Publishes the changes on /wumpus_simulator/WorldDelta, or a keyframe if one is due
+     */
+    void publishDelta(uint32_t resetCount, const WorldRecord& changes);
+
+    void onDeltaTimer(const ros::WallTimerEvent& event);
+
+    /**
+     * Sends yourTurn with the current perception to the agent or wumpus whose turn it is
+     */
+    void announceTurn();
+
+    /**
+     * Places the baseline agents that are not on the playground yet, the simulation has to be locked
+     */
+    void placeBaselineAgents();
+
+    /**
+     * Actions of the agent or wumpus that will not be rejected with bump or notAllowed.
+     * Only uses what the agent can perceive, moves into traps or wumpus are legal.
+     */
+    uint32_t getLegalActions(int id);
+
+    /**
+     * Handles the LoadWorld service
+     */
+    bool onLoadWorld(LoadWorld::Request& req, LoadWorld::Response& res);
+
     /**
      * Handles incoming spawn request
      */
     void onSpawnAgent(InitialPoseRequestPtr msg);
 
+    /**
+     * Handles a batch of spawn requests, the poses of all agents are answered in one message
+     */
+    void onSpawnAgents(SpawnAgentsRequestPtr msg);
+
     /**
      * Handles incoming action request and calls corresponding handle method
      */
@@ -140,6 +383,13 @@ private:
      */
     void placeAgent(int agentId, bool hasArrow);
 
+    /**
+     * Puts the agent on a random spawn tile and into the turn order without sending anything
+     * @param msg InitialPoseResponse filled with the pose of the agent
+     * @return false if the agent is already placed or there is no spawn tile left
+     */
+    bool spawnAgent(int agentId, bool hasArrow, InitialPoseResponse& msg);
+
     /**
      * Enables steering of already placed wumpus
      * @param wumpusId int negative id for wumpus
@@ -147,15 +397,51 @@ private:
     void possessWumpus(int wumpusId);
 
     /**
-     * Delegates mesg to corresponding method
+     * Delegates mesg to the action handlers of the rule set of the current world
      */
     void handleAction(ActionRequestPtr msg);
 
+    /**
+     * Delegates mesg to corresponding method
+     */
+    template <class Rules>
+    void applyAction(ActionRequestPtr msg);
+
+    /**
+     * Picks the rule set instantiation matching the current world
+     */
+    void selectRules();
+
+    template <class Rules>
+    void useRules();
+
     /**
      * Call method according to given message
      */
     void handleWumpusAction(ActionRequestPtr msg);
 
+    /**
+     * Moves the wumpus one tile into the given direction and kills agents on the target tile.
+     * Does not update the stench.
+     */
+    void moveWumpus(EntityHandle wumpus, int direction, ActionResponse& response);
+
+    /**
+     * Sets the stench around every wumpus
+     */
+    void updateStench();
+
+    /**
+     * Moves all unpossessed wumpus that have a behaviour at the same time, once per turn cycle.
+     * Every wumpus decides on the state before the cycle, conflicts go to the wumpus that comes first.
+     */
+    void handleAutonomousWumpus();
+
+    /**
+     * Assigns the behaviour configured in /wumpus_simulator/wumpus_behaviour to all unpossessed wumpus
+     */
+    void assignWumpusBehaviour();
+
     /**
      * Turns the agent right by 90 degrees
      */
@@ -169,6 +455,7 @@ private:
     /**
      * Shoots an arrow in the direction of the agent's current heading
      */
+    template <class Rules>
     void handleShoot(ActionRequestPtr msg);
 
     /**
@@ -194,50 +481,111 @@ private:
      */
     void handleNextTurn();
 
+    template <class Rules>
+    void applyNextTurn();
+
     /**
      * Informs agent about breeze, stench and glitter
      */
     void handlePerception(ActionResponse& msg, std::shared_ptr<GroundTile> tile);
 
     /**
-     * Shoots an arrow to the left killing all wumpus on its way
+     * Shoots an arrow into the direction the agent is facing, killing all wumpus on its way
      */
-    void handleShootLeft(ActionResponse& msg, std::shared_ptr<Agent> agent);
+    void shootArrow(ActionResponse& msg, EntityHandle agent);
 
     /**
-     * Shoots an arrow to the right killing all wumpus on its way
+     * Kills wumpus and removes it from turns
      */
-    void handleShootRight(ActionResponse& msg, std::shared_ptr<Agent> agent);
+    void killWumpus(EntityHandle wumpus);
 
     /**
-     * Shoots an arrow upwards killing all wumpus on its way
+     * Kills agent and removes it from turns
+     * @param cause recorded in the episode results
      */
-    void handleShootUp(ActionResponse& msg, std::shared_ptr<Agent> agent);
+    void killAgent(EntityHandle agent, ScoreBoard::outcome cause);
 
     /**
-     * Shoots an arrow downwards killing all wumpus on its way
+     * Advances turn index
      */
-    void handleShootDown(ActionResponse& msg, std::shared_ptr<Agent> agent);
+    void getNext();
 
     /**
-     * Kills wumpus and removes it from turns
+     * Advances turn index and moves the autonomous wumpus after each complete turn cycle
      */
-    void killWumpus(std::shared_ptr<Wumpus> wumpus);
+    template <class Rules>
+    void advanceTurn();
 
     /**
-     * Kills agent and removes it from turns
+     * Removes the id from the turn order without skipping the following turn
      */
-    void killAgent(std::shared_ptr<Agent> agent);
+    void removeFromTurns(int id);
 
     /**
-     * Advances turn index
+     * Restarts the deadline for the current turn, only touches members so it is safe under the simulation lock
      */
-    void getNext();
+    void startTurnDeadline();
+
+    /**
+     * Polled periodically, skips the current turn if its deadline expired and evicts agents that time out repeatedly
+     */
+    void onTurnDeadline(const ros::WallTimerEvent& event);
+
+    /**
+     * Removes agent from turns and field, possessed wumpus are released instead
+     */
+    void evict(int id);
+
+    /**
+     * Recounts the live agent and wumpus gauges after a world was created or loaded
+     */
+    void updateLiveGauges();
+
+    /**
+     * Starts recording the results of a new episode on the current world
+     */
+    void beginEpisode();
+
+    /**
+     * Starts the next episode if automatic reset is enabled and the current one is over
+     */
+    void checkEpisodeEnd();
+
+    /**
+     * Loads the next world, respawns all registered agents and gives the first one its turn
+     */
+    void resetEpisode();
+
+    /**
+     * Replaces the model with the next world of the index or seed schedule
+     * @return false if the schedule is exhausted
+     */
+    bool loadNextWorld();
+
+    /**
+     * Publishes the metrics on /wumpus_simulator/Stats and writes the Prometheus file
+     */
+    void onMetricsTimer(const ros::WallTimerEvent& event);
+
+    /**
+     * Publishes an action response, traced as its own span. Adds the world hash if enabled.
+     */
+    void publishAction(ActionResponse& response);
+
+    /**
+     * Writes the recorded spans as Chrome trace-event JSON to the trace file
+     */
+    void onFlushTrace(std_msgs::EmptyConstPtr msg);
 
 signals:
     /**
      * Initiates redraw of playground
      */
     void modelChanged();
+
+    /**
+     * Initiates redraw of info bar, grid and playground
+     */
+    void worldChanged();
 };
 } // namespace wumpus_simulator
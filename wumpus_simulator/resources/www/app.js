@@ -3,6 +3,22 @@ var fieldSize = 0;
 var traps = 0;
 var wumpus = 0;
 
+//Pixels per tile of the zoom levels, levels below DETAIL_TILE_SIZE show the overview
+var ZOOM_LEVELS = [50, 32, 16, 8, 4, 2, 1, 0.5, 0.25, 0.125, 0.0625, 0.03125, 0.015625];
+var DETAIL_TILE_SIZE = 16;
+var OVERVIEW_CELL_SIZE = 4;
+var zoomLevel = 0;
+
+//First visible tile and number of visible tiles, only these are part of the DOM
+var viewRow = 0;
+var viewCol = 0;
+var viewRows = 0;
+var viewCols = 0;
+var overviewBlock = 0;
+var viewportTimer = null;
+//Cells of the grid in row-major order, collected once per drawPlayground
+var groundCells = [];
+
 
 //---------------------ENTRY_POINT---------------------
 $(document).ready(function() {
@@ -96,6 +112,48 @@ $(document).ready(function() {
         wumpus_simulator.loadWorld();
 
     });
+
+    //Zoom with the mouse wheel around the center of the view
+    $('#board').on('mousewheel DOMMouseScroll', function(event) {
+
+        var delta = event.originalEvent.wheelDelta || -event.originalEvent.detail;
+        zoom(delta > 0 ? -1 : 1);
+        event.preventDefault();
+
+    });
+
+    //Pan by dragging the board
+    var dragStart = null;
+    $('#board').mousedown(function(event) {
+        dragStart = {x: event.pageX, y: event.pageY, row: viewRow, col: viewCol};
+        event.preventDefault();
+    });
+    $(document).mousemove(function(event) {
+        if(dragStart !== null) {
+            var size = ZOOM_LEVELS[zoomLevel];
+            scrollTo(dragStart.row - Math.round((event.pageY - dragStart.y) / size), dragStart.col - Math.round((event.pageX - dragStart.x) / size));
+        }
+    });
+    $(document).mouseup(function() {
+        dragStart = null;
+    });
+
+    //Pan with the arrow keys, one screen page with shift
+    $(document).keydown(function(event) {
+        var step = event.shiftKey ? Math.max(viewRows, 1) : Math.max(Math.floor(viewRows / 8), 1);
+        switch(event.which) {
+            case 37: scrollTo(viewRow, viewCol - step); break;
+            case 38: scrollTo(viewRow - step, viewCol); break;
+            case 39: scrollTo(viewRow, viewCol + step); break;
+            case 40: scrollTo(viewRow + step, viewCol); break;
+            default: return;
+        }
+        event.preventDefault();
+    });
+
+    $(window).resize(function() {
+        drawPlayground();
+    });
 });
 
 
@@ -115,7 +173,7 @@ function setInitialValues(w, t, f, a) {
 
 }
 
-//Draws the playground, just a grid depending on the field size
+//Draws the visible part of the playground, either as grid of tiles or as overview canvas
 function drawPlayground() {
 
     //Get the table as root
@@ -124,58 +182,177 @@ function drawPlayground() {
     //Clear the board
     root.empty();
 
-    //Create html grid content
-    var grid = '';
+    //Only the tiles inside the window become part of the page
+    var size = ZOOM_LEVELS[zoomLevel];
+    var width = Math.max(root.parent().width(), 100);
+    var height = Math.max($(window).height() - root.offset().top - 20, 100);
+    viewCols = Math.min(fieldSize, Math.ceil(width / (size + 2)));
+    viewRows = Math.min(fieldSize, Math.ceil(height / (size + 2)));
+    viewRow = Math.max(0, Math.min(viewRow, fieldSize - viewRows));
+    viewCol = Math.max(0, Math.min(viewCol, fieldSize - viewCols));
+
+    if(size < DETAIL_TILE_SIZE) {
+
+        //Zoomed out, the simulator sends the density of blocks of tiles
+        overviewBlock = Math.max(1, Math.ceil(OVERVIEW_CELL_SIZE / size));
+        viewCols = Math.min(fieldSize, Math.ceil(width / size));
+        viewRows = Math.min(fieldSize, Math.ceil(height / size));
+        viewRow = Math.max(0, Math.min(viewRow, fieldSize - viewRows));
+        viewCol = Math.max(0, Math.min(viewCol, fieldSize - viewCols));
+        root.html('<canvas id="overview" width="' + Math.ceil(viewCols * size) + '" height="' + Math.ceil(viewRows * size) + '"></canvas>');
+
+    } else {
+
+        overviewBlock = 0;
 
-    for(var i = 0; i < fieldSize; i++) {
+        //Create html grid content
+        var grid = '';
+        var cell = '<div class="ground" style="width: ' + size + 'px; height: ' + size + 'px;"></div>';
 
-        //Append a row
-        grid += '<div style="line-height: 1px;">';
+        for(var i = 0; i < viewRows; i++) {
 
-        for(var j = 0; j < fieldSize; j++) {
+            //Append a row
+            grid += '<div style="line-height: 1px;">';
 
-            //Append a new cell to the last row, the size of a single cell is set in the ground css class in the style.css
-            grid += '<div class="ground"></div>';
+            for(var j = 0; j < viewCols; j++) {
+
+                //Append a new cell to the last row
+                grid += cell;
+
+            }
+
+            //Close the row div
+            grid += '</div>'
 
         }
 
-        //Close the row div
-        grid += '</div>'
+        //Add the grid to the board
+        root.html(grid);
+
+    }
+    groundCells = root[0].querySelectorAll('.ground');
+
+    notifyViewport();
+
+}
+
+//Tells the simulator which tiles are visible, coalescing fast pan and zoom
+function notifyViewport() {
 
+    if(viewportTimer !== null) {
+        clearTimeout(viewportTimer);
     }
+    viewportTimer = setTimeout(function() {
+        viewportTimer = null;
+        wumpus_simulator.setViewport(viewRow, viewCol, viewRows, viewCols, overviewBlock);
+    }, 30);
 
-    //Add the grid to the board
-    root.html(grid);
+}
+
+//Moves the view to the given first tile
+function scrollTo(row, col) {
 
+    row = Math.max(0, Math.min(row, fieldSize - viewRows));
+    col = Math.max(0, Math.min(col, fieldSize - viewCols));
+    if(row === viewRow && col === viewCol) {
+        return;
+    }
+    viewRow = row;
+    viewCol = col;
+    notifyViewport();
+
+}
+
+//Changes the zoom level by the given number of steps, keeping the center tile in place
+function zoom(steps) {
+
+    var level = Math.max(0, Math.min(zoomLevel + steps, ZOOM_LEVELS.length - 1));
+
+    //No need to zoom out further once the whole world fits
+    if(steps > 0 && viewRows >= fieldSize && viewCols >= fieldSize) {
+        return;
+    }
+    if(level === zoomLevel) {
+        return;
+    }
+    var centerRow = viewRow + viewRows / 2;
+    var centerCol = viewCol + viewCols / 2;
+    var factor = ZOOM_LEVELS[zoomLevel] / ZOOM_LEVELS[level];
+    zoomLevel = level;
+    viewRow = Math.floor(centerRow - viewRows * factor / 2);
+    viewCol = Math.floor(centerCol - viewCols * factor / 2);
+    drawPlayground();
+
+}
+
+//Returns the cell showing the tile i, j or nothing if it is not visible
+function cellAt(i, j) {
+    if(i < viewRow || j < viewCol || i >= viewRow + viewRows || j >= viewCol + viewCols) {
+        return $();
+    }
+    return $(groundCells[(i - viewRow) * viewCols + (j - viewCol)]);
+}
+
+//Paints the density of hazards, gold and agents of blocks of tiles, counts are row-major per block
+function drawOverview(block, rows, cols, hazards, gold, agents) {
+
+    var canvas = document.getElementById('overview');
+    if(!canvas) {
+        return;
+    }
+    var context = canvas.getContext('2d');
+    var cellSize = block * ZOOM_LEVELS[zoomLevel];
+    var tiles = block * block;
+
+    //Plain dirt
+    context.fillStyle = '#8d6e63';
+    context.fillRect(0, 0, canvas.width, canvas.height);
+
+    for(var r = 0; r < rows; r++) {
+        for(var c = 0; c < cols; c++) {
+            var index = r * cols + c;
+            if(agents[index] > 0) {
+                context.fillStyle = '#2196f3';
+            } else if(gold[index] > 0) {
+                context.fillStyle = '#ffeb3b';
+            } else if(hazards[index] > 0) {
+                //Darker red for denser hazards
+                context.fillStyle = 'rgba(183, 28, 28, ' + Math.min(1, 0.3 + 4 * hazards[index] / tiles) + ')';
+            } else {
+                continue;
+            }
+            context.fillRect(c * cellSize, r * cellSize, Math.max(cellSize, 1), Math.max(cellSize, 1));
+        }
+    }
 
 }
 
 function clearTiles() {
-    $('.ground').empty();
+    $(groundCells).empty();
 }
 
 function addWumpusImage(i, j) {
-      $($('.ground')[i*fieldSize+j]).prepend('<img class="secondImage" src="img/wumpus.png" > </img>');
+      cellAt(i, j).prepend('<img class="secondImage" src="img/wumpus.png" > </img>');
 }
 
 function addTrapImage(i, j) {
-      $($('.ground')[i*fieldSize+j]).prepend('<img class="secondImage" src="img/trap.png" > </img>');
+      cellAt(i, j).prepend('<img class="secondImage" src="img/trap.png" > </img>');
 }
 
 function addStenchImage(i, j) {
-      $($('.ground')[i*fieldSize+j]).prepend('<img class="thirdImage" src="img/stench.png" > </img>');
+      cellAt(i, j).prepend('<img class="thirdImage" src="img/stench.png" > </img>');
 }
 
 function addBreezeImage(i, j) {
-      $($('.ground')[i*fieldSize+j]).prepend('<img class="fourthImage" src="img/breeze.png" > </img>');
+      cellAt(i, j).prepend('<img class="fourthImage" src="img/breeze.png" > </img>');
 }
 
 function addGoldImage(i, j) {
-    $($('.ground')[i*fieldSize+j]).prepend('<img class="secondImage" src="img/gold.png" > </img>');
+    cellAt(i, j).prepend('<img class="secondImage" src="img/gold.png" > </img>');
 }
 
 function addDirtImage(i, j) {
-    $($('.ground')[i*fieldSize+j]).prepend('<img class="firstImage" src="img/ground.png" > </img>');
+    cellAt(i, j).prepend('<img class="firstImage" src="img/ground.png" > </img>');
 }
 
 function addAgent(i, j, agentID, gender, heading) {
@@ -206,11 +383,11 @@ function addAgent(i, j, agentID, gender, heading) {
 
     html += '.png" > </img>';
 
-    $($('.ground')[i*fieldSize+j]).prepend(html);
+    cellAt(i, j).prepend(html);
 
 }
 
 function addEntryPoint(i, j) {
-    $($('.ground')[i*fieldSize+j]).prepend('<img class="fourthImage" src="img/start.png" > </img>');
+    cellAt(i, j).prepend('<img class="fourthImage" src="img/start.png" > </img>');
 }
 
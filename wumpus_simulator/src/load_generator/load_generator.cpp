@@ -0,0 +1,333 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <model/WumpusEnums.h>
+#include <wumpus_simulator/ActionRequest.h>
+#include <wumpus_simulator/ActionResponse.h>
+#include <wumpus_simulator/InitialPoseRequest.h>
+#include <wumpus_simulator/InitialPoseResponse.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStringList>
+
+#include <ros/ros.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using wumpus_simulator::ActionRequest;
+using wumpus_simulator::ActionResponse;
+using wumpus_simulator::ActionResponseConstPtr;
+using wumpus_simulator::InitialPoseRequest;
+using wumpus_simulator::InitialPoseResponseConstPtr;
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Results of one agent count
+ */
+struct StepResult
+{
+    int agents;
+    int spawned;
+    uint64_t actions;
+    double seconds;
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+
+/**
+ * Synthetic agents that answer every yourTurn with an action right away and measure the
+ * time until the simulator answers the action. The actions only turn the agent, so the
+ * agents never die or leave and the load stays constant.
+ */
+class LoadGenerator
+{
+public:
+    LoadGenerator(int firstId)
+    {
+        this->firstId = firstId;
+        this->measuring = false;
+        this->actions = 0;
+        spawnSub = n.subscribe("/wumpus_simulator/SpawnAgentResponse", 1000, &LoadGenerator::onSpawnResponse, this);
+        actionSub = n.subscribe("/wumpus_simulator/ActionResponse", 1000, &LoadGenerator::onActionResponse, this);
+        spawnPub = n.advertise<InitialPoseRequest>("/wumpus_simulator/SpawnAgentRequest", 1000);
+        actionPub = n.advertise<ActionRequest>("/wumpus_simulator/ActionRequest", 1000);
+    }
+
+    /**
+     * Waits until the simulator is connected to both request topics
+     */
+    bool waitForSimulator(double timeout)
+    {
+        auto deadline = Clock::now() + std::chrono::duration<double>(timeout);
+        while (spawnPub.getNumSubscribers() == 0 || actionPub.getNumSubscribers() == 0) {
+            if (Clock::now() > deadline || !ros::ok()) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return true;
+    }
+
+    /**
+     * Spawns agents until count agents are known to the simulator, previously spawned agents keep playing
+     * @return number of spawned agents
+     */
+    int spawn(int count, double timeout)
+    {
+        auto deadline = Clock::now() + std::chrono::duration<double>(timeout);
+        while (Clock::now() < deadline && ros::ok()) {
+            std::vector<int> missing;
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                for (int id = this->firstId; id < this->firstId + count; id++) {
+                    if (!this->agents[id].spawned) {
+                        missing.push_back(id);
+                    }
+                }
+            }
+            if (missing.empty()) {
+                break;
+            }
+            // Requests can get lost while the connection is set up, repeat them until the pose arrives
+            for (int id : missing) {
+                InitialPoseRequest request;
+                request.agentId = id;
+                spawnPub.publish(request);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+        std::lock_guard<std::mutex> lock(this->mutex);
+        int spawned = 0;
+        for (auto& agent : this->agents) {
+            spawned += agent.second.spawned ? 1 : 0;
+        }
+        return spawned;
+    }
+
+    /**
+     * Lets the agents play for warmup seconds and measures the next seconds
+     */
+    StepResult measure(int agents, int spawned, double warmup, double seconds)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(warmup));
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->latencies.clear();
+            this->actions = 0;
+            this->measuring = true;
+        }
+        auto start = Clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+
+        StepResult result;
+        std::vector<double> samples;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->measuring = false;
+            samples.swap(this->latencies);
+            result.actions = this->actions;
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.agents = agents;
+        result.spawned = spawned;
+        std::sort(samples.begin(), samples.end());
+        result.p50 = percentile(samples, 0.5);
+        result.p99 = percentile(samples, 0.99);
+        result.p999 = percentile(samples, 0.999);
+        result.max = samples.empty() ? 0 : samples.back();
+        return result;
+    }
+
+private:
+    struct Agent
+    {
+        Agent()
+                : spawned(false)
+                , waiting(false)
+        {
+        }
+
+        bool spawned;
+        /**
+         * Set while an action is on its way
+         */
+        bool waiting;
+        Clock::time_point sent;
+    };
+
+    ros::NodeHandle n;
+    ros::Subscriber spawnSub;
+    ros::Subscriber actionSub;
+    ros::Publisher spawnPub;
+    ros::Publisher actionPub;
+
+    std::mutex mutex;
+    std::map<int, Agent> agents;
+    int firstId;
+    bool measuring;
+    uint64_t actions;
+    /**
+     * Round trip times in milliseconds of the current measurement
+     */
+    std::vector<double> latencies;
+
+    static double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        if (sorted.empty()) {
+            return 0;
+        }
+        size_t index = std::min(sorted.size() - 1, (size_t)(fraction * sorted.size()));
+        return sorted.at(index);
+    }
+
+    void onSpawnResponse(InitialPoseResponseConstPtr msg)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto it = this->agents.find(msg->agentId);
+        if (it != this->agents.end()) {
+            it->second.spawned = true;
+        }
+    }
+
+    void onActionResponse(ActionResponseConstPtr msg)
+    {
+        auto now = Clock::now();
+        bool yourTurn = std::find(msg->responses.begin(), msg->responses.end(), WumpusEnums::responses::yourTurn) != msg->responses.end();
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto it = this->agents.find(msg->agentId);
+        if (it == this->agents.end()) {
+            // Another agent or a wumpus
+            return;
+        }
+        Agent& agent = it->second;
+        // A single agent gets the answer of its action and the next yourTurn in separate responses
+        if (agent.waiting && !yourTurn) {
+            agent.waiting = false;
+            if (this->measuring) {
+                this->latencies.push_back(std::chrono::duration<double, std::milli>(now - agent.sent).count());
+                this->actions++;
+            }
+        }
+        if (yourTurn) {
+            ActionRequest request;
+            request.agentId = msg->agentId;
+            request.action = WumpusEnums::actions::turnLeft;
+            agent.waiting = true;
+            agent.sent = Clock::now();
+            actionPub.publish(request);
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "wumpus_load_generator", ros::init_options::AnonymousName);
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("wumpus_load_generator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Spawns synthetic agents against a running simulator and reports action throughput and round trip latency "
+                                     "per number of agents. The simulator needs a world, e.g. /wumpus_simulator/world or auto_reset.");
+    parser.addHelpOption();
+    QCommandLineOption agentOption("agents", "Comma separated, ascending agent counts.", "counts", "1,2,4,8,16,32");
+    QCommandLineOption durationOption("duration", "Seconds measured per agent count.", "seconds", "10");
+    QCommandLineOption warmupOption("warmup", "Seconds played before each measurement.", "seconds", "2");
+    QCommandLineOption firstIdOption("first-id", "Agent ID of the first synthetic agent.", "id", "1");
+    QCommandLineOption outputOption("output", "Also write the results as CSV to this file.", "file");
+    parser.addOption(agentOption);
+    parser.addOption(durationOption);
+    parser.addOption(warmupOption);
+    parser.addOption(firstIdOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    std::vector<int> counts;
+    for (auto& value : parser.value(agentOption).split(",")) {
+        bool ok = false;
+        int count = value.toInt(&ok);
+        if (!ok || count <= 0 || (!counts.empty() && count < counts.back())) {
+            std::cerr << "wumpus_load_generator: invalid agent counts, expected ascending positive numbers" << std::endl;
+            return 1;
+        }
+        counts.push_back(count);
+    }
+    double duration = parser.value(durationOption).toDouble();
+    double warmup = parser.value(warmupOption).toDouble();
+    int firstId = parser.value(firstIdOption).toInt();
+    if (duration <= 0 || warmup < 0 || firstId <= 0) {
+        std::cerr << "wumpus_load_generator: duration and first-id must be positive" << std::endl;
+        return 1;
+    }
+
+    LoadGenerator generator(firstId);
+    ros::AsyncSpinner spinner(2);
+    spinner.start();
+    if (!generator.waitForSimulator(30)) {
+        std::cerr << "wumpus_load_generator: simulator is not running" << std::endl;
+        return 1;
+    }
+
+    std::vector<StepResult> results;
+    std::cout << "agents spawned actions actions/s p50_ms p99_ms p999_ms max_ms" << std::endl;
+    for (int count : counts) {
+        int spawned = generator.spawn(count, 10);
+        if (spawned < count) {
+            std::cerr << "wumpus_load_generator: only " << spawned << " of " << count << " agents were placed" << std::endl;
+        }
+        auto result = generator.measure(count, spawned, warmup, duration);
+        results.push_back(result);
+        std::cout << result.agents << " " << result.spawned << " " << result.actions << " " << result.actions / result.seconds << " " << result.p50 << " "
+                  << result.p99 << " " << result.p999 << " " << result.max << std::endl;
+        if (!ros::ok()) {
+            break;
+        }
+    }
+    spinner.stop();
+
+    if (parser.isSet(outputOption)) {
+        std::string path = parser.value(outputOption).toStdString();
+        std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+        if (!file) {
+            std::cerr << "wumpus_load_generator: couldn't open " << path << std::endl;
+            return 1;
+        }
+        file << "agents,spawned,actions,actions_per_second,p50_ms,p99_ms,p999_ms,max_ms\n";
+        for (auto& result : results) {
+            file << result.agents << "," << result.spawned << "," << result.actions << "," << result.actions / result.seconds << "," << result.p50 << ","
+                 << result.p99 << "," << result.p999 << "," << result.max << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/EntityRegistry.h"
+#include "model/WumpusBehaviour.h"
+
+namespace wumpus_simulator
+{
+
+EntityRegistry::EntityRegistry()
+{
+    this->hash = 0;
+}
+
+EntityRegistry::~EntityRegistry() {}
+
+EntityHandle EntityRegistry::create(kind type, int id, int x, int y)
+{
+    uint32_t index;
+    if (!this->freeSlots.empty()) {
+        index = this->freeSlots.back();
+        this->freeSlots.pop_back();
+    } else {
+        index = this->kinds.size();
+        this->kinds.push_back(none);
+        this->generations.push_back(1);
+        this->ids.push_back(0);
+        this->xs.push_back(0);
+        this->ys.push_back(0);
+        this->headings.push_back(0);
+        this->arrows.push_back(0);
+        this->golds.push_back(0);
+        this->behaviours.push_back(nullptr);
+        this->changed.push_back(false);
+    }
+    this->kinds[index] = type;
+    this->ids[index] = id;
+    this->xs[index] = x;
+    this->ys[index] = y;
+    this->headings[index] = WumpusEnums::heading::up;
+    this->arrows[index] = false;
+    this->golds[index] = false;
+    this->hash ^= getKey(index);
+    addToLookup(index);
+    touch(index);
+    return EntityHandle(index, this->generations[index]);
+}
+
+void EntityRegistry::destroy(EntityHandle entity)
+{
+    if (!isAlive(entity)) {
+        return;
+    }
+    removeFromLookup(entity.index);
+    this->hash ^= getKey(entity.index);
+    this->kinds[entity.index] = none;
+    this->behaviours[entity.index] = nullptr;
+    // Skip 0, it marks invalid handles
+    if (++this->generations[entity.index] == 0) {
+        this->generations[entity.index] = 1;
+    }
+    this->freeSlots.push_back(entity.index);
+}
+
+void EntityRegistry::clear()
+{
+    this->freeSlots.clear();
+    this->slotsById.clear();
+    for (auto& shared : this->sharedSlots) {
+        shared.clear();
+    }
+    this->hash = 0;
+    for (auto index : this->changedSlots) {
+        this->changed[index] = false;
+    }
+    this->changedSlots.clear();
+    for (uint32_t i = this->kinds.size(); i-- > 0;) {
+        if (this->kinds[i] != none) {
+            this->kinds[i] = none;
+            this->behaviours[i] = nullptr;
+            if (++this->generations[i] == 0) {
+                this->generations[i] = 1;
+            }
+        }
+        this->freeSlots.push_back(i);
+    }
+}
+
+std::vector<EntityHandle> EntityRegistry::takeChangedEntities()
+{
+    std::vector<EntityHandle> entities;
+    for (auto index : this->changedSlots) {
+        this->changed[index] = false;
+        // Destroyed entities were removed from their tiles, which marks the tiles themselves
+        if (this->kinds[index] != none) {
+            entities.push_back(EntityHandle(index, this->generations[index]));
+        }
+    }
+    this->changedSlots.clear();
+    return entities;
+}
+
+EntityHandle EntityRegistry::find(int id, kind type)
+{
+    if (id != 0) {
+        auto it = this->slotsById.find(getIdKey(type, id));
+        if (it == this->slotsById.end()) {
+            return EntityHandle();
+        }
+        return EntityHandle(it->second, this->generations[it->second]);
+    }
+    // Drop the entries of slots that were destroyed or renamed since they were added
+    auto& shared = this->sharedSlots[type];
+    while (!shared.empty()) {
+        uint32_t i = shared.back();
+        if (this->kinds[i] == type && this->ids[i] == 0) {
+            return EntityHandle(i, this->generations[i]);
+        }
+        shared.pop_back();
+    }
+    return EntityHandle();
+}
+
+void EntityRegistry::addToLookup(uint32_t index)
+{
+    if (this->ids[index] != 0) {
+        this->slotsById[getIdKey(this->kinds[index], this->ids[index])] = index;
+    } else {
+        this->sharedSlots[this->kinds[index]].push_back(index);
+    }
+}
+
+void EntityRegistry::removeFromLookup(uint32_t index)
+{
+    if (this->ids[index] == 0) {
+        return;
+    }
+    auto it = this->slotsById.find(getIdKey(this->kinds[index], this->ids[index]));
+    if (it != this->slotsById.end() && it->second == index) {
+        this->slotsById.erase(it);
+    }
+}
+
+} /* namespace wumpus_simulator */
@@ -23,7 +23,6 @@
  */
 
 #include "model/GroundTile.h"
-#include "model/Wumpus.h"
 
 namespace wumpus_simulator
 {
@@ -33,12 +32,14 @@ GroundTile::GroundTile(int x, int y)
     this->x = x;
     this->y = y;
     this->startAgentID = 0;
-    this->hasGold = false;
     this->hasTrap = false;
-    this->hasStench = false;
-    this->hasBreeze = false;
     this->isStartpoint = false;
-    this->movable = nullptr;
+    this->perception = 0;
+    this->entityKind = EntityRegistry::none;
+    this->dirty = false;
+    this->hash = nullptr;
+    this->spawnTiles = nullptr;
+    this->spawnable = true;
 }
 
 GroundTile::~GroundTile() {}
@@ -55,12 +56,12 @@ int GroundTile::getY()
 
 bool GroundTile::getGold()
 {
-    return hasGold;
+    return perception & shinyMask;
 }
 
 bool GroundTile::getStench()
 {
-    return hasStench;
+    return perception & stinkyMask;
 }
 
 bool GroundTile::getTrap()
@@ -75,12 +76,20 @@ int GroundTile::getStartAgentID()
 
 void GroundTile::setStartAgentID(int value)
 {
+    if (startAgentID != value) {
+        toggle(Zobrist::startAgentID, (uint32_t) startAgentID);
+        toggle(Zobrist::startAgentID, (uint32_t) value);
+    }
     startAgentID = value;
 }
 
 void GroundTile::setStartpoint(bool value)
 {
+    if (isStartpoint != value) {
+        toggle(Zobrist::startpoint);
+    }
     isStartpoint = value;
+    updateSpawnable();
 }
 
 bool GroundTile::getStartpoint()
@@ -90,54 +99,122 @@ bool GroundTile::getStartpoint()
 
 void GroundTile::setGold(bool value)
 {
-    hasGold = value;
+    if (getGold() != value) {
+        toggle(Zobrist::gold);
+    }
+    perception = value ? (perception | shinyMask) : (perception & ~shinyMask);
+    updateSpawnable();
 }
 
 void GroundTile::setTrap(bool value)
 {
+    if (hasTrap != value) {
+        toggle(Zobrist::trap);
+    }
     hasTrap = value;
+    updateSpawnable();
 }
 
 void GroundTile::setStench(bool value)
 {
-    hasStench = value;
+    if (getStench() != value) {
+        toggle(Zobrist::stench);
+    }
+    perception = value ? (perception | stinkyMask) : (perception & ~stinkyMask);
+    updateSpawnable();
 }
 
-bool GroundTile::hasMovable()
+bool GroundTile::hasEntity()
 {
-    if (movable != nullptr) {
-        return true;
-    } else {
-        return false;
-    }
+    return entityKind != EntityRegistry::none;
+}
+
+EntityHandle GroundTile::getEntity()
+{
+    return entity;
 }
 
-std::shared_ptr<Movable> GroundTile::getMovable()
+void GroundTile::setEntity(EntityHandle entity, EntityRegistry::kind type)
 {
-    return movable;
+    if (entityKind != type) {
+        toggle(Zobrist::tileEntity, entityKind);
+        toggle(Zobrist::tileEntity, type);
+    }
+    this->entity = entity;
+    this->entityKind = type;
+    updateSpawnable();
 }
 
-void GroundTile::setMovable(std::shared_ptr<Movable> movable)
+void GroundTile::clearEntity()
 {
-    this->movable = movable;
+    toggle(Zobrist::tileEntity, entityKind);
+    this->entity = EntityHandle();
+    this->entityKind = EntityRegistry::none;
+    updateSpawnable();
 }
 
 bool GroundTile::getBreeze()
 {
-    return hasBreeze;
+    return perception & draftyMask;
 }
 
 void GroundTile::setBreeze(bool hasBreeze)
 {
-    this->hasBreeze = hasBreeze;
+    if (getBreeze() != hasBreeze) {
+        toggle(Zobrist::breeze);
+    }
+    perception = hasBreeze ? (perception | draftyMask) : (perception & ~draftyMask);
+    updateSpawnable();
 }
 
 bool GroundTile::hasWumpus()
 {
-    if (!this->hasMovable()) {
-        return false;
+    return entityKind == EntityRegistry::wumpus;
+}
+
+bool GroundTile::hasAgent()
+{
+    return entityKind == EntityRegistry::agent;
+}
+
+bool GroundTile::isDirty()
+{
+    return dirty;
+}
+
+void GroundTile::setDirty(bool value)
+{
+    dirty = value;
+}
+
+void GroundTile::setHash(uint64_t* hash)
+{
+    this->hash = hash;
+}
+
+void GroundTile::setSpawnTiles(SpawnTiles* spawnTiles)
+{
+    this->spawnTiles = spawnTiles;
+}
+
+void GroundTile::updateSpawnable()
+{
+    bool value = !hasTrap && perception == 0 && entityKind == EntityRegistry::none && !isStartpoint;
+    if (value == this->spawnable || this->spawnTiles == nullptr) {
+        return;
+    }
+    this->spawnable = value;
+    if (value) {
+        this->spawnTiles->add(x, y);
     } else {
-        return std::dynamic_pointer_cast<Wumpus>(this->movable) != nullptr;
+        this->spawnTiles->remove(x, y);
+    }
+}
+
+void GroundTile::toggle(Zobrist::feature type, uint64_t value)
+{
+    if (this->hash != nullptr && value != 0) {
+        *this->hash ^= Zobrist::key(Zobrist::tileLocation(x, y), type, value);
     }
 }
 
@@ -0,0 +1,98 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/KnowledgeMap.h"
+
+namespace wumpus_simulator
+{
+
+KnowledgeMap::KnowledgeMap(int size)
+        : visited(size)
+        , perceived(size)
+{
+    this->visitedCount = 0;
+    this->perceivedCount = 0;
+}
+
+KnowledgeMap::~KnowledgeMap() {}
+
+void KnowledgeMap::visit(int x, int y)
+{
+    if (!this->visited.test(x, y)) {
+        this->visited.set(x, y);
+        this->visitedCount++;
+    }
+    perceive(x, y);
+    perceive(x - 1, y);
+    perceive(x + 1, y);
+    perceive(x, y - 1);
+    perceive(x, y + 1);
+}
+
+void KnowledgeMap::perceive(int x, int y)
+{
+    int size = this->perceived.getSize();
+    if (x < 0 || y < 0 || x >= size || y >= size || this->perceived.test(x, y)) {
+        return;
+    }
+    this->perceived.set(x, y);
+    this->perceivedCount++;
+}
+
+bool KnowledgeMap::isVisited(int x, int y) const
+{
+    return visited.test(x, y);
+}
+
+bool KnowledgeMap::isPerceived(int x, int y) const
+{
+    return perceived.test(x, y);
+}
+
+int KnowledgeMap::getVisitedCount() const
+{
+    return visitedCount;
+}
+
+int KnowledgeMap::getPerceivedCount() const
+{
+    return perceivedCount;
+}
+
+const TileBitset& KnowledgeMap::getVisited() const
+{
+    return visited;
+}
+
+const TileBitset& KnowledgeMap::getPerceived() const
+{
+    return perceived;
+}
+
+size_t KnowledgeMap::getMemoryUsage() const
+{
+    return visited.getMemoryUsage() + perceived.getMemoryUsage();
+}
+
+} /* namespace wumpus_simulator */
@@ -23,15 +23,15 @@
  */
 
 #include "model/Model.h"
-#include "model/Agent.h"
 #include "model/GroundTile.h"
-#include "model/Wumpus.h"
+#include "model/WorldGenerator.h"
+#include "model/WorldLibrary.h"
 
 #include <QJsonArray>
 #include <QJsonObject>
 
+#include <algorithm>
 #include <memory>
-#include <stdlib.h> /* srand, rand */
 #include <time.h>
 
 namespace wumpus_simulator
@@ -45,104 +45,113 @@ Model* Model::get()
 
 void Model::init(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize)
 {
-    this->playGround.clear();
+    init(agentHasArrow, wumpusCount, trapCount, playGroundSize, time(NULL));
+}
+
+void Model::init(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize, unsigned int seed)
+{
+    WorldGenerator generator(wumpusCount, trapCount, playGroundSize);
+    init(agentHasArrow, generator.generate(seed));
+}
+
+void Model::initSolvable(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize, int threadCount)
+{
+    initSolvable(agentHasArrow, wumpusCount, trapCount, playGroundSize, threadCount, time(NULL));
+}
+
+void Model::initSolvable(bool agentHasArrow, int wumpusCount, int trapCount, int playGroundSize, int threadCount, unsigned int seed)
+{
+    WorldGenerator generator(wumpusCount, trapCount, playGroundSize);
+    init(agentHasArrow, generator.generateSolvable(seed, threadCount, MAX_SOLVABLE_CANDIDATES));
+}
+
+void Model::init(bool agentHasArrow, const WorldLayout& layout)
+{
     this->agentHasArrow = agentHasArrow;
-    this->playGroundSize = playGroundSize;
-    this->trapCount = trapCount;
-    this->wumpusCount = wumpusCount;
-    for (int i = 0; i < this->playGroundSize; i++) {
-        this->playGround.push_back(std::vector<std::shared_ptr<GroundTile>>());
-    }
-    for (int i = 0; i < this->playGroundSize; i++) {
-        for (int j = 0; j < this->playGroundSize; j++) {
-            this->playGround.at(i).push_back(std::make_shared<GroundTile>(i, j));
-        }
+    this->playGroundSize = layout.playGroundSize;
+    this->trapCount = layout.traps.size();
+    this->wumpusCount = layout.wumpus.size();
+    this->seed = layout.seed;
+    this->knowledge.clear();
+    // Nothing of a previous world survives
+    this->entities.clear();
+    // Tiles are allocated lazily by the playground once something is placed on them
+    this->playGround.reset(this->playGroundSize);
+    if (!this->quiet) {
+        std::cout << "Tiles created" << std::endl;
     }
-    std::cout << "Tiles created" << std::endl;
-    // initialize random seed:
-    srand(time(NULL));
-    // Place given number of traps on field
-    for (int i = 0; i < trapCount; i++) {
-        int randx = rand() % (this->playGroundSize - 1);
-        int randy = rand() % (this->playGroundSize - 1);
-
-        if (!playGround.at(randx).at(randy)->getTrap()) {
-            playGround.at(randx).at(randy)->setTrap(true);
-            setBreeze(randx, randy);
-        } else {
-            i--;
-        }
+    // Place traps on field
+    for (auto& trap : layout.traps) {
+        playGround.getTile(trap.first, trap.second)->setTrap(true);
+        setBreeze(trap.first, trap.second);
+    }
+    if (!this->quiet) {
+        std::cout << "Traps created" << std::endl;
     }
-    std::cout << "Traps created" << std::endl;
     // Place Wumpus on field
-    for (int i = 0; i < wumpusCount; i++) {
-        int randx = rand() % (this->playGroundSize - 1);
-        int randy = rand() % (this->playGroundSize - 1);
-
-        if (playGround.at(randx).at(randy)->getTrap() || playGround.at(randx).at(randy)->hasMovable()) {
-            i--;
-        } else {
-            auto tmp = std::make_shared<Wumpus>(playGround.at(randx).at(randy));
-            playGround.at(randx).at(randy)->setMovable(tmp);
-            setStench(randx, randy);
-            this->movables.push_back(tmp);
-        }
+    for (auto& pos : layout.wumpus) {
+        auto wumpus = this->entities.create(EntityRegistry::wumpus, 0, pos.first, pos.second);
+        playGround.getTile(pos.first, pos.second)->setEntity(wumpus, EntityRegistry::wumpus);
+        setStench(pos.first, pos.second);
+    }
+    if (!this->quiet) {
+        std::cout << "Wumpus created" << std::endl;
     }
-    std::cout << "Wumpus created" << std::endl;
 
     // Place Gold on field
-    bool placed = false;
-    while (!placed) {
-        int randx = rand() % (this->playGroundSize - 1);
-        int randy = rand() % (this->playGroundSize - 1);
-
-        if (!(playGround.at(randx).at(randy)->getTrap() || playGround.at(randx).at(randy)->hasMovable())) {
-            playGround.at(randx).at(randy)->setGold(true);
-            placed = true;
-        }
+    playGround.getTile(layout.gold.first, layout.gold.second)->setGold(true);
+    if (!this->quiet) {
+        std::cout << "Gold placed" << std::endl;
     }
-    std::cout << "Gold placed" << std::endl;
-    for (int i = 0; i < this->playGround.size(); i++) {
-        for (int j = 0; j < this->playGround.size(); j++) {
-            if (this->playGround.at(i).at(j)->hasMovable() || this->playGround.at(i).at(j)->getTrap()) {
-                this->playGround.at(i).at(j)->setBreeze(false);
-                this->playGround.at(i).at(j)->setStench(false);
-            }
+    // Traps and wumpus are always allocated, so only allocated tiles need to be checked
+    for (auto tile : this->playGround.getAllocatedTiles()) {
+        if (tile->hasEntity() || tile->getTrap()) {
+            tile->setBreeze(false);
+            tile->setStench(false);
         }
     }
-    std::cout << "Model: Finished initiating the playground!" << std::endl;
+    if (!this->quiet) {
+        std::cout << "Model: Finished initiating the playground with seed " << this->seed
+                  << "! Allocated chunks: " << this->playGround.getAllocatedChunkCount() << std::endl;
+    }
 }
 
 Model::Model()
 {
-    rosNode = new ros::NodeHandle();
     this->agentHasArrow = false;
     this->playGroundSize = -1;
     this->trapCount = -1;
     this->wumpusCount = -1;
+    this->seed = 0;
+    this->quiet = false;
 }
 
 Model::~Model() {}
 
+void Model::setQuiet(bool quiet)
+{
+    this->quiet = quiet;
+}
+
 void Model::setBreeze(int x, int y)
 {
     if (x == 0) {
-        playGround.at(x + 1).at(y)->setBreeze(true);
+        playGround.getTile(x + 1, y)->setBreeze(true);
 
     } else if (x == playGroundSize - 1) {
-        playGround.at(x - 1).at(y)->setBreeze(true);
+        playGround.getTile(x - 1, y)->setBreeze(true);
 
     } else {
-        playGround.at(x - 1).at(y)->setBreeze(true);
-        playGround.at(x + 1).at(y)->setBreeze(true);
+        playGround.getTile(x - 1, y)->setBreeze(true);
+        playGround.getTile(x + 1, y)->setBreeze(true);
     }
 
     if (y > 0) {
-        playGround.at(x).at(y - 1)->setBreeze(true);
+        playGround.getTile(x, y - 1)->setBreeze(true);
     }
 
     if (y < playGroundSize - 1) {
-        playGround.at(x).at(y + 1)->setBreeze(true);
+        playGround.getTile(x, y + 1)->setBreeze(true);
     }
 }
 
@@ -166,23 +175,29 @@ int Model::getWumpusCount()
     return wumpusCount;
 }
 
-std::vector<std::vector<std::shared_ptr<GroundTile>>> Model::getPlayGround()
+unsigned int Model::getSeed()
+{
+    return seed;
+}
+
+PlayGround& Model::getPlayGround()
 {
     return playGround;
 }
 
-void Model::exit(std::shared_ptr<Agent> agent)
+void Model::exit(EntityHandle agent)
 {
-    this->movables.erase(remove(this->movables.begin(), this->movables.end(), agent), this->movables.end());
-    agent->getTile()->setMovable(nullptr);
-    agent->setTile(nullptr);
-    for (auto tileVec : this->playGround) {
-        for (auto tile : tileVec) {
-            if (tile->getStartAgentID() == agent->getId()) {
-                tile->setStartAgentID(0);
-                tile->setStartpoint(false);
-                break;
-            }
+    if (!this->entities.isAlive(agent)) {
+        return;
+    }
+    int id = this->entities.getId(agent);
+    getTile(agent)->clearEntity();
+    this->entities.destroy(agent);
+    for (auto tile : this->playGround.getAllocatedTiles()) {
+        if (tile->getStartAgentID() == id) {
+            tile->setStartAgentID(0);
+            tile->setStartpoint(false);
+            break;
         }
     }
 }
@@ -190,40 +205,55 @@ void Model::exit(std::shared_ptr<Agent> agent)
 void Model::setStench(int x, int y)
 {
     if (x == 0) {
-        if (!playGround.at(x + 1).at(y)->hasWumpus()) {
-            playGround.at(x + 1).at(y)->setStench(true);
+        if (!playGround.getTile(x + 1, y)->hasWumpus()) {
+            playGround.getTile(x + 1, y)->setStench(true);
         }
 
     } else if (x == playGroundSize - 1) {
-        if (!playGround.at(x - 1).at(y)->hasWumpus()) {
-            playGround.at(x - 1).at(y)->setStench(true);
+        if (!playGround.getTile(x - 1, y)->hasWumpus()) {
+            playGround.getTile(x - 1, y)->setStench(true);
         }
 
     } else {
-        if (!playGround.at(x - 1).at(y)->hasWumpus()) {
-            playGround.at(x - 1).at(y)->setStench(true);
+        if (!playGround.getTile(x - 1, y)->hasWumpus()) {
+            playGround.getTile(x - 1, y)->setStench(true);
         }
-        if (!playGround.at(x + 1).at(y)->hasWumpus()) {
-            playGround.at(x + 1).at(y)->setStench(true);
+        if (!playGround.getTile(x + 1, y)->hasWumpus()) {
+            playGround.getTile(x + 1, y)->setStench(true);
         }
     }
 
     if (y > 0) {
-        if (!playGround.at(x).at(y - 1)->hasWumpus()) {
-            playGround.at(x).at(y - 1)->setStench(true);
+        if (!playGround.getTile(x, y - 1)->hasWumpus()) {
+            playGround.getTile(x, y - 1)->setStench(true);
         }
     }
 
     if (y < playGroundSize - 1) {
-        if (!playGround.at(x).at(y + 1)->hasWumpus()) {
-            playGround.at(x).at(y + 1)->setStench(true);
+        if (!playGround.getTile(x, y + 1)->hasWumpus()) {
+            playGround.getTile(x, y + 1)->setStench(true);
         }
     }
 }
 
 std::shared_ptr<GroundTile> Model::getTile(int x, int y)
 {
-    return this->playGround.at(x).at(y);
+    return this->playGround.getTile(x, y);
+}
+
+std::shared_ptr<GroundTile> Model::peekTile(int x, int y)
+{
+    return this->playGround.peekTile(x, y);
+}
+
+std::shared_ptr<GroundTile> Model::getTile(EntityHandle entity)
+{
+    return this->playGround.getTile(this->entities.getX(entity), this->entities.getY(entity));
+}
+
+std::shared_ptr<GroundTile> Model::peekTile(EntityHandle entity)
+{
+    return this->playGround.peekTile(this->entities.getX(entity), this->entities.getY(entity));
 }
 
 QJsonObject Model::toJSON()
@@ -236,42 +266,40 @@ QJsonObject Model::toJSON()
     world["wumpusCount"] = wumpusCount;
     world["trapCount"] = trapCount;
     world["agentHasArrow"] = agentHasArrow;
+    world["seed"] = (double) seed;
 
-    // JSON Array to hold the playground
+    // JSON Array to hold the playground, untouched dirt tiles are left out
     QJsonArray playground;
-    for (int i = 0; i < playGroundSize; i++) {
-
-        for (int j = 0; j < playGroundSize; j++) {
-
-            QJsonObject ground;
-            ground["x"] = playGround.at(i).at(j)->getX();
-            ground["y"] = playGround.at(i).at(j)->getY();
-            ground["hasTrap"] = playGround.at(i).at(j)->getTrap();
-            ground["hasGold"] = playGround.at(i).at(j)->getGold();
-            ground["hasStench"] = playGround.at(i).at(j)->getStench();
-            ground["hasBreeze"] = playGround.at(i).at(j)->getBreeze();
-            ground["isStartpoint"] = playGround.at(i).at(j)->getStartpoint();
-            ground["startAgentID"] = playGround.at(i).at(j)->getStartAgentID();
-            if (playGround.at(i).at(j)->getMovable() != nullptr) {
-                ground["movableType"] = playGround.at(i).at(j)->getMovable()->getType();
-                auto tmp = std::dynamic_pointer_cast<Agent>(playGround.at(i).at(j)->getMovable());
-                if (tmp != nullptr) {
-                    ground["agentHeading"] = tmp->getHeading();
-                    ground["agentId"] = tmp->getId();
-                    ground["agentHasGold"] = tmp->getHasGold();
-                    ground["agentHasArrow"] = tmp->hasArrow();
-                } else {
-                    ground["agentHeading"] = "unknown";
-                    ground["agantId"] = 0;
-                }
+    for (auto tile : this->playGround.getAllocatedTiles()) {
+
+        QJsonObject ground;
+        ground["x"] = tile->getX();
+        ground["y"] = tile->getY();
+        ground["hasTrap"] = tile->getTrap();
+        ground["hasGold"] = tile->getGold();
+        ground["hasStench"] = tile->getStench();
+        ground["hasBreeze"] = tile->getBreeze();
+        ground["isStartpoint"] = tile->getStartpoint();
+        ground["startAgentID"] = tile->getStartAgentID();
+        if (tile->hasEntity()) {
+            auto entity = tile->getEntity();
+            ground["movableType"] = tile->hasAgent() ? "agent" : "wumpus";
+            if (tile->hasAgent()) {
+                ground["agentHeading"] = this->entities.getHeading(entity);
+                ground["agentId"] = this->entities.getId(entity);
+                ground["agentHasGold"] = this->entities.hasGold(entity);
+                ground["agentHasArrow"] = this->entities.hasArrow(entity);
             } else {
-                ground["movableType"] = "unknown";
                 ground["agentHeading"] = "unknown";
-                ground["agentId"] = 0;
+                ground["agantId"] = 0;
             }
-
-            playground.append(ground);
+        } else {
+            ground["movableType"] = "unknown";
+            ground["agentHeading"] = "unknown";
+            ground["agentId"] = 0;
         }
+
+        playground.append(ground);
     }
 
     world["playground"] = playground;
@@ -280,107 +308,254 @@ QJsonObject Model::toJSON()
 }
 
 void Model::fromJSON(QJsonObject root)
+{
+    fromRecord(WorldLibrary::parse(root));
+}
+
+void Model::fromRecord(const WorldRecord& world)
 {
 
-    // Clear the old vectors
-    this->playGround.clear();
-    this->movables.clear();
+    // Clear the old entities
+    this->entities.clear();
     // Reset global variables
-    this->agentHasArrow = root["agentHasArrow"].toBool();
-    this->playGroundSize = root["playGroundSize"].toInt();
-    this->trapCount = root["trapCount"].toInt();
-    this->wumpusCount = root["wumpusCount"].toInt();
+    this->agentHasArrow = world.agentHasArrow;
+    this->playGroundSize = world.playGroundSize;
+    this->trapCount = world.trapCount;
+    this->wumpusCount = world.wumpusCount;
+    this->seed = world.seed;
     // Init the playground
-    for (int i = 0; i < this->playGroundSize; i++) {
-        this->playGround.push_back(std::vector<std::shared_ptr<GroundTile>>());
-    }
-    for (int i = 0; i < this->playGroundSize; i++) {
-        for (int j = 0; j < this->playGroundSize; j++) {
-            this->playGround.at(i).push_back(std::make_shared<GroundTile>(i, j));
+    this->playGround.reset(this->playGroundSize);
+    this->knowledge.clear();
+    // Load the playground, the record only contains tiles that are not plain dirt
+    for (auto& tile : world.tiles) {
+        auto groundTile = this->playGround.getTile(tile.x, tile.y);
+        groundTile->setBreeze(tile.breeze);
+        groundTile->setGold(tile.gold);
+        groundTile->setStench(tile.stench);
+        groundTile->setStartAgentID(tile.startAgentID);
+        groundTile->setStartpoint(tile.startpoint);
+        groundTile->setTrap(tile.trap);
+        if (tile.entity == EntityRegistry::wumpus) {
+            // Possessed wumpus keep their id in checkpoints, world files contain 0
+            auto wumpus = this->entities.create(EntityRegistry::wumpus, tile.agentId, tile.x, tile.y);
+            groundTile->setEntity(wumpus, EntityRegistry::wumpus);
+        } else if (tile.entity == EntityRegistry::agent) {
+            auto agent = this->entities.create(EntityRegistry::agent, tile.agentId, tile.x, tile.y);
+            this->entities.setHeading(agent, (WumpusEnums::heading) tile.agentHeading);
+            this->entities.setHasGold(agent, tile.agentHasGold);
+            this->entities.setArrow(agent, tile.agentHasArrow);
+            groundTile->setEntity(agent, EntityRegistry::agent);
+            visit(this->entities.getId(agent), tile.x, tile.y);
         }
     }
-    // Load the playground
-    QJsonArray tiles = root["playground"].toArray();
-    for (int i = 0; i < tiles.size(); i++) {
-        QJsonObject tile = tiles[i].toObject();
-        auto x = tile["x"].toInt();
-        auto y = tile["y"].toInt();
-        auto groundTile = this->playGround.at(x).at(y);
-        groundTile->setBreeze(tile["hasBreeze"].toBool());
-        groundTile->setGold(tile["hasGold"].toBool());
-        groundTile->setStench(tile["hasStench"].toBool());
-        groundTile->setStartAgentID(tile["startAgentID"].toInt());
-        groundTile->setStartpoint(tile["isStartpoint"].toBool());
-        groundTile->setTrap(tile["hasTrap"].toBool());
-        if (tile["movableType"].toString().contains("wumpus")) {
-            auto wumpus = std::make_shared<Wumpus>(this->playGround.at(x).at(y));
-            this->movables.push_back(wumpus);
-            groundTile->setMovable(wumpus);
-        } else if (tile["movableType"].toString().contains("agent")) {
-            auto agent = std::make_shared<Agent>(this->playGround.at(x).at(y));
-            agent->setHeading((WumpusEnums::heading) tile["agentHeading"].toInt());
-            agent->setId(tile["agentId"].toInt());
-            agent->setHasGold(tile["agentHasGold"].toBool());
-            agent->setArrow(tile["agentHasArrow"].toBool());
-            this->movables.push_back(agent);
-            groundTile->setMovable(agent);
-        }
+}
+
+uint32_t Model::takeChanges(WorldRecord& changes)
+{
+    changes.agentHasArrow = this->agentHasArrow;
+    changes.playGroundSize = this->playGroundSize;
+    changes.wumpusCount = this->wumpusCount;
+    changes.trapCount = this->trapCount;
+    changes.seed = this->seed;
+    changes.tiles.clear();
+    markChangedEntities();
+    for (auto& tile : this->playGround.takeDirtyTiles()) {
+        changes.tiles.push_back(toWorldTile(tile));
     }
+    return this->playGround.getResetCount();
+}
+
+uint64_t Model::getHash()
+{
+    return this->playGround.getHash() ^ this->entities.getHash();
 }
 
-std::shared_ptr<Agent> Model::getAgentByID(int id)
+uint32_t Model::toRecord(WorldRecord& world)
 {
+    world.agentHasArrow = this->agentHasArrow;
+    world.playGroundSize = this->playGroundSize;
+    world.wumpusCount = this->wumpusCount;
+    world.trapCount = this->trapCount;
+    world.seed = this->seed;
+    world.tiles.clear();
+    for (auto& tile : this->playGround.getAllocatedTiles()) {
+        world.tiles.push_back(toWorldTile(tile));
+    }
+    return this->playGround.getResetCount();
+}
 
-    for (auto mov : this->movables) {
+bool Model::pickSpawnTile(std::minstd_rand& random, int& x, int& y)
+{
+    return this->playGround.getSpawnTiles().pick(random, x, y);
+}
 
-        if (mov->getId() == id) {
-            return std::dynamic_pointer_cast<Agent>(mov);
+int64_t Model::getSpawnTileCount()
+{
+    return this->playGround.getSpawnTiles().size();
+}
+
+std::shared_ptr<const RenderSnapshot> Model::takeSnapshot(const std::shared_ptr<const RenderSnapshot>& previous)
+{
+    auto snapshot = std::make_shared<RenderSnapshot>();
+    snapshot->version = previous != nullptr ? previous->version + 1 : 1;
+    snapshot->resetCount = this->playGround.getResetCount();
+    snapshot->playGroundSize = this->playGroundSize;
+    snapshot->wumpusCount = this->wumpusCount;
+    snapshot->trapCount = this->trapCount;
+    snapshot->agentHasArrow = this->agentHasArrow;
+    snapshot->seed = this->seed;
+
+    markChangedEntities();
+    auto changedChunks = this->playGround.takeChangedChunks();
+    int chunkCount = this->playGround.getChunksPerSide() * this->playGround.getChunksPerSide();
+    if (previous == nullptr || previous->resetCount != snapshot->resetCount) {
+        for (int first = 0; first < chunkCount; first += RenderSnapshot::PAGE_CHUNKS) {
+            auto page = std::make_shared<RenderSnapshot::Page>(std::min(chunkCount, first + RenderSnapshot::PAGE_CHUNKS) - first);
+            for (size_t i = 0; i < page->size(); i++) {
+                (*page)[i] = copyChunk(first + i);
+            }
+            snapshot->pages.push_back(page);
         }
+        return snapshot;
     }
-    return nullptr;
+
+    // Only the spine and the pages with changed chunks are copied, the other pages are shared
+    snapshot->pages = previous->pages;
+    std::sort(changedChunks.begin(), changedChunks.end());
+    std::shared_ptr<RenderSnapshot::Page> page;
+    for (int index : changedChunks) {
+        int pageIndex = index / RenderSnapshot::PAGE_CHUNKS;
+        if (page == nullptr || snapshot->pages[pageIndex] != page) {
+            page = std::make_shared<RenderSnapshot::Page>(*previous->pages[pageIndex]);
+            snapshot->pages[pageIndex] = page;
+        }
+        (*page)[index % RenderSnapshot::PAGE_CHUNKS] = copyChunk(index);
+    }
+    return snapshot;
 }
 
-std::shared_ptr<Wumpus> Model::getWumpusByID(int id)
+void Model::markChangedEntities()
 {
+    // Turned or possessed entities change their tile without touching it
+    for (auto& entity : this->entities.takeChangedEntities()) {
+        this->playGround.markDirty(this->entities.getX(entity), this->entities.getY(entity));
+    }
+}
 
-    for (auto mov : this->movables) {
-
-        if (mov->getId() == id) {
-            return std::dynamic_pointer_cast<Wumpus>(mov);
+std::shared_ptr<const RenderSnapshot::Chunk> Model::copyChunk(int index)
+{
+    auto tiles = this->playGround.getChunkTiles(index);
+    if (tiles == nullptr) {
+        return nullptr;
+    }
+    auto chunk = std::make_shared<RenderSnapshot::Chunk>(tiles->size(), RenderCell{0, 0, 0});
+    for (size_t i = 0; i < tiles->size(); i++) {
+        auto& tile = (*tiles)[i];
+        if (tile == nullptr) {
+            continue;
+        }
+        auto& cell = (*chunk)[i];
+        cell.state = (tile->getTrap() ? RenderSnapshot::trap : 0) | (tile->getGold() ? RenderSnapshot::gold : 0) |
+                (tile->getStench() ? RenderSnapshot::stench : 0) | (tile->getBreeze() ? RenderSnapshot::breeze : 0) |
+                (tile->getStartpoint() ? RenderSnapshot::startpoint : 0);
+        auto entity = tile->getEntity();
+        if (tile->hasEntity() && this->entities.isAlive(entity)) {
+            cell.state |= tile->hasWumpus() ? RenderSnapshot::wumpus : RenderSnapshot::agent;
+            cell.agentId = this->entities.getId(entity);
+            cell.heading = this->entities.getHeading(entity);
         }
     }
-    return nullptr;
+    return chunk;
+}
+
+WorldTile Model::toWorldTile(std::shared_ptr<GroundTile> tile)
+{
+    WorldTile result;
+    result.x = tile->getX();
+    result.y = tile->getY();
+    result.trap = tile->getTrap();
+    result.gold = tile->getGold();
+    result.stench = tile->getStench();
+    result.breeze = tile->getBreeze();
+    result.startpoint = tile->getStartpoint();
+    result.startAgentID = tile->getStartAgentID();
+    result.entity = EntityRegistry::none;
+    result.agentId = 0;
+    result.agentHeading = 0;
+    result.agentHasGold = false;
+    result.agentHasArrow = false;
+    if (tile->hasEntity()) {
+        auto entity = tile->getEntity();
+        result.entity = this->entities.getKind(entity);
+        result.agentId = this->entities.getId(entity);
+        result.agentHeading = this->entities.getHeading(entity);
+        result.agentHasGold = this->entities.hasGold(entity);
+        result.agentHasArrow = this->entities.hasArrow(entity);
+    }
+    return result;
+}
+
+EntityHandle Model::getAgentByID(int id)
+{
+    return this->entities.find(id, EntityRegistry::agent);
+}
+
+EntityHandle Model::getWumpusByID(int id)
+{
+    return this->entities.find(id, EntityRegistry::wumpus);
 }
 
-void Model::removeAgent(std::shared_ptr<Agent> agent)
+void Model::moveEntity(EntityHandle entity, int x, int y)
 {
-    agent->getTile()->setMovable(nullptr);
-    agent->setTile(nullptr);
+    auto from = getTile(entity);
+    if (from->getEntity() == entity) {
+        from->clearEntity();
+    }
+    this->playGround.getTile(x, y)->setEntity(entity, this->entities.getKind(entity));
+    this->entities.setPosition(entity, x, y);
 }
 
-void Model::removeWumpus(std::shared_ptr<Wumpus> wumpus)
+void Model::removeWumpus(EntityHandle wumpus)
 {
-    int x = wumpus->getTile()->getX();
-    int y = wumpus->getTile()->getY();
+    int x = this->entities.getX(wumpus);
+    int y = this->entities.getY(wumpus);
     if (x == 0) {
-        playGround.at(x + 1).at(y)->setStench(false);
+        playGround.getTile(x + 1, y)->setStench(false);
 
     } else if (x == playGroundSize - 1) {
-        playGround.at(x - 1).at(y)->setStench(false);
+        playGround.getTile(x - 1, y)->setStench(false);
 
     } else {
-        playGround.at(x - 1).at(y)->setStench(false);
-        playGround.at(x + 1).at(y)->setStench(false);
+        playGround.getTile(x - 1, y)->setStench(false);
+        playGround.getTile(x + 1, y)->setStench(false);
     }
 
     if (y > 0) {
-        playGround.at(x).at(y - 1)->setStench(false);
+        playGround.getTile(x, y - 1)->setStench(false);
     }
 
     if (y < playGroundSize - 1) {
-        playGround.at(x).at(y + 1)->setStench(false);
+        playGround.getTile(x, y + 1)->setStench(false);
+    }
+    playGround.getTile(x, y)->clearEntity();
+}
+
+void Model::visit(int agentId, int x, int y)
+{
+    auto& map = this->knowledge[agentId];
+    if (map == nullptr) {
+        map = std::make_shared<KnowledgeMap>(this->playGroundSize);
+    }
+    map->visit(x, y);
+}
+
+std::shared_ptr<KnowledgeMap> Model::getKnowledge(int agentId)
+{
+    auto it = this->knowledge.find(agentId);
+    if (it == this->knowledge.end()) {
+        return nullptr;
     }
-    wumpus->getTile()->setMovable(nullptr);
+    return it->second;
 }
 
 } /* namespace wumpus_simulator */
@@ -0,0 +1,273 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/MoveResolver.h"
+#include "model/GroundTile.h"
+#include "model/Model.h"
+#include "model/WumpusBehaviour.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace wumpus_simulator
+{
+
+MoveResolver::MoveResolver()
+{
+    this->regionSize = 64;
+    this->stopping = false;
+    this->task = nullptr;
+    this->taskCount = 0;
+    this->nextTask = 0;
+    this->generation = 0;
+    this->busyWorkers = 0;
+}
+
+MoveResolver::~MoveResolver()
+{
+    stop();
+}
+
+void MoveResolver::start(int threadCount, int regionSize)
+{
+    stop();
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    this->regionSize = std::max(2, regionSize);
+    this->stopping = false;
+    for (int t = 1; t < threadCount; t++) {
+        this->workers.push_back(std::thread(&MoveResolver::work, this));
+    }
+}
+
+void MoveResolver::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wakeup.notify_all();
+    for (auto& worker : this->workers) {
+        worker.join();
+    }
+    this->workers.clear();
+}
+
+std::vector<MoveIntent> MoveResolver::resolve(Model* model, const std::vector<EntityHandle>& wumpus)
+{
+    int size = model->getPlayGroundSize();
+    std::vector<MoveIntent> intents(wumpus.size());
+    std::function<void(size_t)> decide = [&](size_t batch) {
+        size_t end = std::min(intents.size(), (batch + 1) * INTENT_BATCH);
+        for (size_t i = batch * INTENT_BATCH; i < end; i++) {
+            auto& intent = intents[i];
+            intent.wumpus = wumpus[i];
+            intent.direction = model->entities.getBehaviour(wumpus[i])->nextMove(wumpus[i], model);
+            intent.moves = false;
+            int x = model->entities.getX(wumpus[i]);
+            int y = model->entities.getY(wumpus[i]);
+            intent.source = (int64_t) x * size + y;
+            intent.target = -1;
+            if (intent.direction == WumpusBehaviour::NO_MOVE) {
+                continue;
+            }
+            WumpusBehaviour::step(intent.direction, x, y);
+            if (x >= 0 && y >= 0 && x < size && y < size) {
+                intent.target = (int64_t) x * size + y;
+            }
+        }
+    };
+    bool parallel = !this->workers.empty() && wumpus.size() >= MIN_PARALLEL_MOVES;
+    if (parallel) {
+        parallelFor((intents.size() + INTENT_BATCH - 1) / INTENT_BATCH, decide);
+    } else {
+        for (size_t batch = 0; batch * INTENT_BATCH < intents.size(); batch++) {
+            decide(batch);
+        }
+    }
+
+    std::vector<uint32_t> all;
+    if (!parallel) {
+        for (uint32_t i = 0; i < intents.size(); i++) {
+            all.push_back(i);
+        }
+        resolveSerial(model, intents, all);
+        return intents;
+    }
+
+    // Sort the moves into regions, moves across a border mark their tiles on both sides
+    int64_t regionsPerSide = (size + this->regionSize - 1) / this->regionSize;
+    auto regionOf = [&](int64_t tile) { return (tile / size / this->regionSize) * regionsPerSide + (tile % size) / this->regionSize; };
+    std::unordered_map<int64_t, size_t> regionIndex;
+    std::vector<std::vector<uint32_t>> regions;
+    std::vector<std::unordered_set<int64_t>> borderTiles;
+    std::vector<uint32_t> crossing;
+    auto getRegion = [&](int64_t region) {
+        auto it = regionIndex.find(region);
+        if (it != regionIndex.end()) {
+            return it->second;
+        }
+        regionIndex[region] = regions.size();
+        regions.push_back(std::vector<uint32_t>());
+        borderTiles.push_back(std::unordered_set<int64_t>());
+        return regions.size() - 1;
+    };
+    for (uint32_t i = 0; i < intents.size(); i++) {
+        auto& intent = intents[i];
+        if (intent.target < 0) {
+            continue;
+        }
+        size_t from = getRegion(regionOf(intent.source));
+        size_t to = getRegion(regionOf(intent.target));
+        if (from == to) {
+            regions[from].push_back(i);
+        } else {
+            crossing.push_back(i);
+            borderTiles[from].insert(intent.source);
+            borderTiles[to].insert(intent.target);
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> deferred(regions.size());
+    parallelFor(regions.size(), [&](size_t region) { resolveRegion(model, intents, regions[region], borderTiles[region], deferred[region]); });
+
+    // Second phase in the original order, these groups may span several regions
+    for (auto& region : deferred) {
+        crossing.insert(crossing.end(), region.begin(), region.end());
+    }
+    std::sort(crossing.begin(), crossing.end());
+    resolveSerial(model, intents, crossing);
+    return intents;
+}
+
+void MoveResolver::resolveSerial(Model* model, std::vector<MoveIntent>& intents, const std::vector<uint32_t>& indices)
+{
+    int size = model->getPlayGroundSize();
+    // Wumpus occupancy of the tiles that changed in this tick
+    std::unordered_map<int64_t, bool> occupied;
+    for (auto i : indices) {
+        auto& intent = intents[i];
+        if (intent.target < 0) {
+            intent.moves = false;
+            continue;
+        }
+        auto it = occupied.find(intent.target);
+        bool blocked = it != occupied.end() ? it->second : model->peekTile(intent.target / size, intent.target % size)->hasWumpus();
+        intent.moves = !blocked;
+        if (intent.moves) {
+            occupied[intent.source] = false;
+            occupied[intent.target] = true;
+        }
+    }
+}
+
+void MoveResolver::resolveRegion(Model* model, std::vector<MoveIntent>& intents, const std::vector<uint32_t>& indices,
+        const std::unordered_set<int64_t>& borderTiles, std::vector<uint32_t>& deferred)
+{
+    // Union find over the moves of this region, moves are connected if they touch a common tile
+    std::vector<uint32_t> parent(indices.size());
+    std::unordered_map<int64_t, uint32_t> owner;
+    auto find = [&](uint32_t k) {
+        while (parent[k] != k) {
+            parent[k] = parent[parent[k]];
+            k = parent[k];
+        }
+        return k;
+    };
+    for (uint32_t k = 0; k < indices.size(); k++) {
+        parent[k] = k;
+        for (int64_t tile : {intents[indices[k]].source, intents[indices[k]].target}) {
+            auto it = owner.find(tile);
+            if (it == owner.end()) {
+                owner[tile] = k;
+            } else {
+                parent[find(k)] = find(it->second);
+            }
+        }
+    }
+
+    // Groups that share a tile with a move across the border wait for the second phase
+    std::vector<bool> blocked(indices.size(), false);
+    for (auto tile : borderTiles) {
+        auto it = owner.find(tile);
+        if (it != owner.end()) {
+            blocked[find(it->second)] = true;
+        }
+    }
+    std::vector<uint32_t> local;
+    for (uint32_t k = 0; k < indices.size(); k++) {
+        if (blocked[find(k)]) {
+            deferred.push_back(indices[k]);
+        } else {
+            local.push_back(indices[k]);
+        }
+    }
+    resolveSerial(model, intents, local);
+}
+
+void MoveResolver::parallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = &task;
+        this->taskCount = count;
+        this->nextTask = 0;
+        this->busyWorkers = this->workers.size();
+        this->generation++;
+    }
+    this->wakeup.notify_all();
+    runTasks();
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->done.wait(lock, [this]() { return this->busyWorkers == 0; });
+    this->task = nullptr;
+}
+
+void MoveResolver::runTasks()
+{
+    for (size_t i = this->nextTask++; i < this->taskCount; i = this->nextTask++) {
+        (*this->task)(i);
+    }
+}
+
+void MoveResolver::work()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    int seen = this->generation;
+    while (true) {
+        this->wakeup.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+        if (this->stopping) {
+            return;
+        }
+        seen = this->generation;
+        lock.unlock();
+        runTasks();
+        lock.lock();
+        if (--this->busyWorkers == 0) {
+            this->done.notify_one();
+        }
+    }
+}
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,198 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/PlayGround.h"
+#include "model/GroundTile.h"
+
+#include <stdexcept>
+
+namespace wumpus_simulator
+{
+
+PlayGround::PlayGround()
+{
+    this->size = 0;
+    this->chunksPerSide = 0;
+    this->allocatedChunks = 0;
+    this->resetCount = 0;
+    this->hash = 0;
+    this->defaultTile = std::make_shared<GroundTile>(-1, -1);
+}
+
+PlayGround::~PlayGround() {}
+
+void PlayGround::reset(int size)
+{
+    this->size = size;
+    this->chunksPerSide = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    this->allocatedChunks = 0;
+    this->chunks.clear();
+    this->chunks.resize(this->chunksPerSide * this->chunksPerSide);
+    this->dirtyTiles.clear();
+    this->changedChunks.clear();
+    this->resetCount++;
+    this->hash = 0;
+    this->spawnTiles.reset(size);
+}
+
+int PlayGround::getSize()
+{
+    return size;
+}
+
+std::shared_ptr<GroundTile>* PlayGround::findSlot(int x, int y, bool allocate)
+{
+    if (x < 0 || y < 0 || x >= this->size || y >= this->size) {
+        throw std::out_of_range("PlayGround: tile coordinates out of range");
+    }
+    auto& chunk = this->chunks.at((x / CHUNK_SIZE) * this->chunksPerSide + (y / CHUNK_SIZE));
+    if (chunk == nullptr) {
+        if (!allocate) {
+            return nullptr;
+        }
+        chunk.reset(new Chunk());
+        chunk->tiles.resize(CHUNK_SIZE * CHUNK_SIZE);
+        chunk->changed = false;
+        this->allocatedChunks++;
+    }
+    return &chunk->tiles.at((x % CHUNK_SIZE) * CHUNK_SIZE + (y % CHUNK_SIZE));
+}
+
+std::shared_ptr<GroundTile> PlayGround::getTile(int x, int y)
+{
+    auto slot = findSlot(x, y, true);
+    if (*slot == nullptr) {
+        *slot = std::make_shared<GroundTile>(x, y);
+        (*slot)->setHash(&this->hash);
+        (*slot)->setSpawnTiles(&this->spawnTiles);
+    }
+    markChanged(*slot, x, y);
+    return *slot;
+}
+
+void PlayGround::markDirty(int x, int y)
+{
+    auto slot = findSlot(x, y, false);
+    if (slot != nullptr && *slot != nullptr) {
+        markChanged(*slot, x, y);
+    }
+}
+
+void PlayGround::markChanged(const std::shared_ptr<GroundTile>& tile, int x, int y)
+{
+    if (!tile->isDirty()) {
+        tile->setDirty(true);
+        this->dirtyTiles.push_back(tile);
+    }
+    int index = (x / CHUNK_SIZE) * this->chunksPerSide + (y / CHUNK_SIZE);
+    auto& chunk = this->chunks[index];
+    if (!chunk->changed) {
+        chunk->changed = true;
+        this->changedChunks.push_back(index);
+    }
+}
+
+std::shared_ptr<GroundTile> PlayGround::peekTile(int x, int y)
+{
+    auto slot = findSlot(x, y, false);
+    if (slot == nullptr || *slot == nullptr) {
+        return this->defaultTile;
+    }
+    return *slot;
+}
+
+bool PlayGround::isAllocated(int x, int y)
+{
+    auto slot = findSlot(x, y, false);
+    return slot != nullptr && *slot != nullptr;
+}
+
+std::vector<std::shared_ptr<GroundTile>> PlayGround::getAllocatedTiles()
+{
+    std::vector<std::shared_ptr<GroundTile>> tiles;
+    for (auto& chunk : this->chunks) {
+        if (chunk == nullptr) {
+            continue;
+        }
+        for (auto tile : chunk->tiles) {
+            if (tile != nullptr) {
+                tiles.push_back(tile);
+            }
+        }
+    }
+    return tiles;
+}
+
+int PlayGround::getAllocatedChunkCount()
+{
+    return allocatedChunks;
+}
+
+std::vector<std::shared_ptr<GroundTile>> PlayGround::takeDirtyTiles()
+{
+    std::vector<std::shared_ptr<GroundTile>> tiles;
+    tiles.swap(this->dirtyTiles);
+    for (auto& tile : tiles) {
+        tile->setDirty(false);
+    }
+    return tiles;
+}
+
+std::vector<int> PlayGround::takeChangedChunks()
+{
+    std::vector<int> indices;
+    indices.swap(this->changedChunks);
+    for (int index : indices) {
+        this->chunks[index]->changed = false;
+    }
+    return indices;
+}
+
+int PlayGround::getChunksPerSide()
+{
+    return chunksPerSide;
+}
+
+const std::vector<std::shared_ptr<GroundTile>>* PlayGround::getChunkTiles(int index)
+{
+    auto& chunk = this->chunks.at(index);
+    return chunk == nullptr ? nullptr : &chunk->tiles;
+}
+
+uint32_t PlayGround::getResetCount()
+{
+    return resetCount;
+}
+
+uint64_t PlayGround::getHash()
+{
+    return hash;
+}
+
+SpawnTiles& PlayGround::getSpawnTiles()
+{
+    return spawnTiles;
+}
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,93 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/RenderSnapshot.h"
+#include "model/PlayGround.h"
+
+#include <algorithm>
+
+namespace wumpus_simulator
+{
+
+RenderCell RenderSnapshot::getCell(int x, int y) const
+{
+    auto chunk = getChunk((x / PlayGround::CHUNK_SIZE) * getChunksPerSide() + (y / PlayGround::CHUNK_SIZE));
+    if (chunk == nullptr) {
+        return RenderCell{0, 0, 0};
+    }
+    return chunk->at((x % PlayGround::CHUNK_SIZE) * PlayGround::CHUNK_SIZE + (y % PlayGround::CHUNK_SIZE));
+}
+
+Overview RenderSnapshot::getOverview(int x, int y, int rows, int cols, int block) const
+{
+    Overview overview;
+    overview.block = std::max(block, 1);
+    overview.rows = (rows + overview.block - 1) / overview.block;
+    overview.cols = (cols + overview.block - 1) / overview.block;
+    size_t cells = (size_t) overview.rows * overview.cols;
+    overview.hazards.assign(cells, 0);
+    overview.gold.assign(cells, 0);
+    overview.agents.assign(cells, 0);
+    int chunksPerSide = getChunksPerSide();
+    int lastX = std::min(x + rows, this->playGroundSize);
+    int lastY = std::min(y + cols, this->playGroundSize);
+    for (int chunkX = std::max(x, 0) / PlayGround::CHUNK_SIZE; chunkX * PlayGround::CHUNK_SIZE < lastX; chunkX++) {
+        for (int chunkY = std::max(y, 0) / PlayGround::CHUNK_SIZE; chunkY * PlayGround::CHUNK_SIZE < lastY; chunkY++) {
+            auto chunk = getChunk(chunkX * chunksPerSide + chunkY);
+            if (chunk == nullptr) {
+                continue;
+            }
+            // Only the part of the chunk inside the region
+            int firstX = std::max(x, chunkX * PlayGround::CHUNK_SIZE);
+            int firstY = std::max(y, chunkY * PlayGround::CHUNK_SIZE);
+            int endX = std::min(lastX, (chunkX + 1) * PlayGround::CHUNK_SIZE);
+            int endY = std::min(lastY, (chunkY + 1) * PlayGround::CHUNK_SIZE);
+            for (int i = firstX; i < endX; i++) {
+                for (int j = firstY; j < endY; j++) {
+                    auto& cell = (*chunk)[(i % PlayGround::CHUNK_SIZE) * PlayGround::CHUNK_SIZE + (j % PlayGround::CHUNK_SIZE)];
+                    if (cell.state == 0) {
+                        continue;
+                    }
+                    size_t index = (size_t)((i - x) / overview.block) * overview.cols + (j - y) / overview.block;
+                    overview.hazards[index] += ((cell.state & trap) != 0) + ((cell.state & wumpus) != 0);
+                    overview.gold[index] += (cell.state & gold) != 0;
+                    overview.agents[index] += (cell.state & agent) != 0;
+                }
+            }
+        }
+    }
+    return overview;
+}
+
+const RenderSnapshot::Chunk* RenderSnapshot::getChunk(int index) const
+{
+    return this->pages.at(index / PAGE_CHUNKS)->at(index % PAGE_CHUNKS).get();
+}
+
+int RenderSnapshot::getChunksPerSide() const
+{
+    return (this->playGroundSize + PlayGround::CHUNK_SIZE - 1) / PlayGround::CHUNK_SIZE;
+}
+
+} /* namespace wumpus_simulator */
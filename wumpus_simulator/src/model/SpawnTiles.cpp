@@ -0,0 +1,125 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/SpawnTiles.h"
+
+namespace wumpus_simulator
+{
+
+SpawnTiles::SpawnTiles()
+{
+    this->edge = 0;
+    this->count = 0;
+}
+
+SpawnTiles::~SpawnTiles() {}
+
+void SpawnTiles::reset(int size)
+{
+    this->edge = size;
+    this->count = (int64_t) size * size;
+    this->tiles.clear();
+    this->positions.clear();
+}
+
+void SpawnTiles::add(int x, int y)
+{
+    int64_t position = getPosition((int64_t) x * this->edge + y);
+    if (position < this->count) {
+        return;
+    }
+    // Move the tile to the first position behind the members and extend the members by it
+    swap(position, this->count);
+    this->count++;
+}
+
+void SpawnTiles::remove(int x, int y)
+{
+    int64_t position = getPosition((int64_t) x * this->edge + y);
+    if (position >= this->count) {
+        return;
+    }
+    // Move the tile to the last member position and cut it off
+    swap(position, this->count - 1);
+    this->count--;
+}
+
+bool SpawnTiles::contains(int x, int y)
+{
+    return getPosition((int64_t) x * this->edge + y) < this->count;
+}
+
+int64_t SpawnTiles::size()
+{
+    return this->count;
+}
+
+bool SpawnTiles::pick(std::minstd_rand& random, int& x, int& y)
+{
+    if (this->count == 0) {
+        return false;
+    }
+    int64_t tile = getTile(std::uniform_int_distribution<int64_t>(0, this->count - 1)(random));
+    x = tile / this->edge;
+    y = tile % this->edge;
+    return true;
+}
+
+int64_t SpawnTiles::getTile(int64_t position)
+{
+    auto it = this->tiles.find(position);
+    return it == this->tiles.end() ? position : it->second;
+}
+
+int64_t SpawnTiles::getPosition(int64_t tile)
+{
+    auto it = this->positions.find(tile);
+    return it == this->positions.end() ? tile : it->second;
+}
+
+void SpawnTiles::swap(int64_t first, int64_t second)
+{
+    if (first == second) {
+        return;
+    }
+    int64_t firstTile = getTile(first);
+    int64_t secondTile = getTile(second);
+    // Entries that are back at the identity are dropped to keep the maps small
+    if (secondTile == first) {
+        this->tiles.erase(first);
+        this->positions.erase(secondTile);
+    } else {
+        this->tiles[first] = secondTile;
+        this->positions[secondTile] = first;
+    }
+    if (firstTile == second) {
+        this->tiles.erase(second);
+        this->positions.erase(firstTile);
+    } else {
+        this->tiles[second] = firstTile;
+        this->positions[firstTile] = second;
+    }
+}
+
+} /* namespace wumpus_simulator */
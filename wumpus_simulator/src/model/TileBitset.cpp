@@ -22,42 +22,46 @@
  * SOFTWARE.
  */
 
-#include "model/Movable.h"
+#include "model/TileBitset.h"
+
+#include <algorithm>
 
 namespace wumpus_simulator
 {
 
-Movable::Movable()
+TileBitset::TileBitset()
 {
-    this->id = 0;
-    type = "unknown";
+    this->size = 0;
 }
 
-Movable::~Movable() {}
-
-QString Movable::getType()
+TileBitset::TileBitset(int size)
 {
-    return type;
+    reset(size);
 }
 
-std::shared_ptr<GroundTile> Movable::getTile()
+void TileBitset::reset(int size)
 {
-    return tile;
+    this->size = size;
+    this->words.assign(((int64_t) size * size + 63) / 64, 0);
 }
 
-void Movable::setTile(std::shared_ptr<GroundTile> tile)
+void TileBitset::clearAll()
 {
-    this->tile = tile;
+    std::fill(this->words.begin(), this->words.end(), 0);
 }
 
-int Movable::getId()
+int TileBitset::count() const
 {
-    return id;
+    int bits = 0;
+    for (auto word : this->words) {
+        bits += __builtin_popcountll(word);
+    }
+    return bits;
 }
 
-void Movable::setId(int id)
+size_t TileBitset::getMemoryUsage() const
 {
-    this->id = id;
+    return this->words.size() * sizeof(uint64_t);
 }
 
 } /* namespace wumpus_simulator */
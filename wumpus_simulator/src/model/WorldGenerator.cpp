@@ -0,0 +1,246 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/WorldGenerator.h"
+#include "model/BitBoard.h"
+#include "model/TileBitset.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace wumpus_simulator
+{
+
+WorldGenerator::WorldGenerator(int wumpusCount, int trapCount, int playGroundSize)
+{
+    this->wumpusCount = wumpusCount;
+    this->trapCount = trapCount;
+    this->playGroundSize = playGroundSize;
+    this->candidateCount = 0;
+    this->solvableCount = 0;
+    this->candidatesPerSecond = 0;
+}
+
+WorldGenerator::~WorldGenerator() {}
+
+WorldLayout WorldGenerator::generate(unsigned int seed)
+{
+    WorldLayout layout;
+    layout.seed = seed;
+    layout.playGroundSize = this->playGroundSize;
+    std::minstd_rand random(seed);
+    TileBitset occupied(this->playGroundSize);
+
+    // Place given number of traps on field
+    for (int i = 0; i < this->trapCount; i++) {
+        int randx = random() % this->playGroundSize;
+        int randy = random() % this->playGroundSize;
+
+        if (!occupied.test(randx, randy)) {
+            occupied.set(randx, randy);
+            layout.traps.push_back(std::make_pair(randx, randy));
+        } else {
+            i--;
+        }
+    }
+    // Place Wumpus on field
+    for (int i = 0; i < this->wumpusCount; i++) {
+        int randx = random() % this->playGroundSize;
+        int randy = random() % this->playGroundSize;
+
+        if (!occupied.test(randx, randy)) {
+            occupied.set(randx, randy);
+            layout.wumpus.push_back(std::make_pair(randx, randy));
+        } else {
+            i--;
+        }
+    }
+    // Place Gold on field
+    while (true) {
+        int randx = random() % this->playGroundSize;
+        int randy = random() % this->playGroundSize;
+
+        if (!occupied.test(randx, randy)) {
+            layout.gold = std::make_pair(randx, randy);
+            break;
+        }
+    }
+    return layout;
+}
+
+bool WorldGenerator::isSolvable(const WorldLayout& layout)
+{
+    return getGoldDistance(layout) >= 0;
+}
+
+int WorldGenerator::getGoldDistance(const WorldLayout& layout)
+{
+    int size = layout.playGroundSize;
+    // Small worlds fit into a single machine word per plane
+    switch (size) {
+    case 2:
+        return BitBoard<2>::getGoldDistance(layout);
+    case 3:
+        return BitBoard<3>::getGoldDistance(layout);
+    case 4:
+        return BitBoard<4>::getGoldDistance(layout);
+    case 5:
+        return BitBoard<5>::getGoldDistance(layout);
+    case 6:
+        return BitBoard<6>::getGoldDistance(layout);
+    case 7:
+        return BitBoard<7>::getGoldDistance(layout);
+    case 8:
+        return BitBoard<8>::getGoldDistance(layout);
+    }
+    // Tiles that kill an agent and tiles an agent can never be spawned on
+    TileBitset deadly(size);
+    TileBitset noStart(size);
+    for (auto& trap : layout.traps) {
+        deadly.set(trap.first, trap.second);
+    }
+    for (auto& wumpus : layout.wumpus) {
+        deadly.set(wumpus.first, wumpus.second);
+    }
+    std::vector<std::pair<int, int>> hazards(layout.traps);
+    hazards.insert(hazards.end(), layout.wumpus.begin(), layout.wumpus.end());
+    for (auto& hazard : hazards) {
+        // Breeze and stench around every hazard
+        noStart.set(hazard.first, hazard.second);
+        if (hazard.first > 0) {
+            noStart.set(hazard.first - 1, hazard.second);
+        }
+        if (hazard.first < size - 1) {
+            noStart.set(hazard.first + 1, hazard.second);
+        }
+        if (hazard.second > 0) {
+            noStart.set(hazard.first, hazard.second - 1);
+        }
+        if (hazard.second < size - 1) {
+            noStart.set(hazard.first, hazard.second + 1);
+        }
+    }
+    noStart.set(layout.gold.first, layout.gold.second);
+
+    // Breadth first flood fill from the gold over all tiles that are safe to enter
+    TileBitset visited(size);
+    std::vector<std::pair<int, int>> open;
+    std::vector<std::pair<int, int>> next;
+    open.push_back(layout.gold);
+    visited.set(layout.gold.first, layout.gold.second);
+    for (int distance = 0; !open.empty(); distance++) {
+        for (auto& tile : open) {
+            if (!noStart.test(tile.first, tile.second)) {
+                return distance;
+            }
+            const int dx[] = {-1, 1, 0, 0};
+            const int dy[] = {0, 0, -1, 1};
+            for (int i = 0; i < 4; i++) {
+                int x = tile.first + dx[i];
+                int y = tile.second + dy[i];
+                if (x < 0 || y < 0 || x >= size || y >= size || visited.test(x, y) || deadly.test(x, y)) {
+                    continue;
+                }
+                visited.set(x, y);
+                next.push_back(std::make_pair(x, y));
+            }
+        }
+        open.swap(next);
+        next.clear();
+    }
+    return -1;
+}
+
+WorldLayout WorldGenerator::generateSolvable(unsigned int seed, int threadCount, int maxCandidates)
+{
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::atomic<int> candidates(0);
+    std::atomic<int> solvable(0);
+    // Lowest candidate index found to be solvable so far
+    std::atomic<int> bestIndex(maxCandidates);
+    std::mutex resultMutex;
+    WorldLayout result;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread([&, t]() {
+            // Only candidates with a lower index than the current best can still win
+            for (int i = t; i < bestIndex.load(); i += threadCount) {
+                auto layout = generate(seed + i);
+                candidates++;
+                if (!isSolvable(layout)) {
+                    continue;
+                }
+                solvable++;
+                std::lock_guard<std::mutex> lock(resultMutex);
+                if (i < bestIndex.load()) {
+                    bestIndex = i;
+                    result = layout;
+                }
+                break;
+            }
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    this->candidateCount = candidates;
+    this->solvableCount = solvable;
+    this->candidatesPerSecond = elapsed.count() > 0 ? candidates / elapsed.count() : 0;
+    std::cout << "WorldGenerator: checked " << this->candidateCount << " candidates on " << threadCount << " threads in " << elapsed.count() << "s ("
+              << this->candidatesPerSecond << " candidates/s, " << this->solvableCount << " solvable)" << std::endl;
+
+    if (bestIndex.load() >= maxCandidates) {
+        std::cout << "WorldGenerator: no solvable world found, using unchecked world with seed " << seed << std::endl;
+        return generate(seed);
+    }
+    return result;
+}
+
+int WorldGenerator::getCandidateCount()
+{
+    return candidateCount;
+}
+
+int WorldGenerator::getSolvableCount()
+{
+    return solvableCount;
+}
+
+double WorldGenerator::getCandidatesPerSecond()
+{
+    return candidatesPerSecond;
+}
+
+} /* namespace wumpus_simulator */
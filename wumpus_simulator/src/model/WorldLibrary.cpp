@@ -0,0 +1,213 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/WorldLibrary.h"
+#include "model/EntityRegistry.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <iostream>
+
+namespace wumpus_simulator
+{
+
+WorldLibrary::WorldLibrary() {}
+
+WorldLibrary::~WorldLibrary() {}
+
+WorldRecord WorldLibrary::parse(const QJsonObject& root)
+{
+    WorldRecord world;
+    world.agentHasArrow = root["agentHasArrow"].toBool();
+    world.playGroundSize = root["playGroundSize"].toInt();
+    world.trapCount = root["trapCount"].toInt();
+    world.wumpusCount = root["wumpusCount"].toInt();
+    world.seed = (unsigned int) root["seed"].toDouble(0);
+    QJsonArray tiles = root["playground"].toArray();
+    for (int i = 0; i < tiles.size(); i++) {
+        QJsonObject tile = tiles[i].toObject();
+        WorldTile entry;
+        entry.x = tile["x"].toInt();
+        entry.y = tile["y"].toInt();
+        entry.trap = tile["hasTrap"].toBool();
+        entry.gold = tile["hasGold"].toBool();
+        entry.stench = tile["hasStench"].toBool();
+        entry.breeze = tile["hasBreeze"].toBool();
+        entry.startpoint = tile["isStartpoint"].toBool();
+        entry.startAgentID = tile["startAgentID"].toInt();
+        QString type = tile["movableType"].toString();
+        entry.entity = type.contains("wumpus") ? EntityRegistry::wumpus : type.contains("agent") ? EntityRegistry::agent : EntityRegistry::none;
+        entry.agentId = tile["agentId"].toInt();
+        entry.agentHeading = tile["agentHeading"].toInt();
+        entry.agentHasGold = tile["agentHasGold"].toBool();
+        entry.agentHasArrow = tile["agentHasArrow"].toBool();
+        // Plain dirt stays unallocated in the model
+        if (!(entry.trap || entry.gold || entry.stench || entry.breeze || entry.startpoint || entry.entity != EntityRegistry::none)) {
+            continue;
+        }
+        world.tiles.push_back(entry);
+    }
+    return world;
+}
+
+QJsonObject WorldLibrary::serialize(const WorldRecord& world)
+{
+    QJsonObject root;
+    root["playGroundSize"] = world.playGroundSize;
+    root["wumpusCount"] = world.wumpusCount;
+    root["trapCount"] = world.trapCount;
+    root["agentHasArrow"] = world.agentHasArrow;
+    root["seed"] = (double) world.seed;
+    QJsonArray playground;
+    for (auto& entry : world.tiles) {
+        if (!(entry.trap || entry.gold || entry.stench || entry.breeze || entry.startpoint || entry.entity != EntityRegistry::none)) {
+            continue;
+        }
+        QJsonObject tile;
+        tile["x"] = entry.x;
+        tile["y"] = entry.y;
+        tile["hasTrap"] = entry.trap;
+        tile["hasGold"] = entry.gold;
+        tile["hasStench"] = entry.stench;
+        tile["hasBreeze"] = entry.breeze;
+        tile["isStartpoint"] = entry.startpoint;
+        tile["startAgentID"] = entry.startAgentID;
+        tile["movableType"] = entry.entity == EntityRegistry::agent ? "agent" : entry.entity == EntityRegistry::wumpus ? "wumpus" : "unknown";
+        tile["agentId"] = entry.agentId;
+        tile["agentHeading"] = entry.agentHeading;
+        tile["agentHasGold"] = entry.agentHasGold;
+        tile["agentHasArrow"] = entry.agentHasArrow;
+        playground.append(tile);
+    }
+    root["playground"] = playground;
+    return root;
+}
+
+std::vector<std::string> WorldLibrary::preload(const QString& path)
+{
+    QStringList files;
+    QFileInfo info(path);
+    if (info.isDir()) {
+        QDir dir(path);
+        for (auto& name : dir.entryList(QStringList() << "*.wwf", QDir::Files, QDir::Name)) {
+            files.append(dir.filePath(name));
+        }
+    } else {
+        // File names in the index are relative to its directory
+        QFile index(path);
+        if (!index.open(QIODevice::ReadOnly)) {
+            std::cout << "WorldLibrary: couldn't open " << path.toStdString() << std::endl;
+            return std::vector<std::string>();
+        }
+        QJsonArray worlds = QJsonDocument::fromJson(index.readAll()).object()["worlds"].toArray();
+        for (int i = 0; i < worlds.size(); i++) {
+            files.append(info.dir().filePath(worlds.at(i).toObject()["file"].toString()));
+        }
+    }
+
+    std::vector<std::string> loaded;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto& file : files) {
+        auto world = read(file);
+        if (world == nullptr) {
+            continue;
+        }
+        // A file with the same name elsewhere owns the ID, only the path finds this one
+        loaded.push_back(this->byId.at(world->id) == world ? world->id : QFileInfo(file).absoluteFilePath().toStdString());
+    }
+    std::cout << "WorldLibrary: " << loaded.size() << " worlds loaded from " << path.toStdString() << std::endl;
+    return loaded;
+}
+
+std::shared_ptr<const WorldRecord> WorldLibrary::get(const std::string& world)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->byId.find(world);
+    if (it != this->byId.end()) {
+        return it->second;
+    }
+    QString path = QFileInfo(QString::fromStdString(world)).absoluteFilePath();
+    auto cached = this->byPath.find(path.toStdString());
+    if (cached != this->byPath.end()) {
+        return cached->second;
+    }
+    return read(path);
+}
+
+std::vector<std::string> WorldLibrary::getIds()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->ids;
+}
+
+size_t WorldLibrary::size()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->ids.size();
+}
+
+std::shared_ptr<const WorldRecord> WorldLibrary::read(const QString& path)
+{
+    QFileInfo info(path);
+    QString absolutePath = info.absoluteFilePath();
+    auto cached = this->byPath.find(absolutePath.toStdString());
+    if (cached != this->byPath.end()) {
+        return cached->second;
+    }
+
+    QFile file(absolutePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cout << "WorldLibrary: couldn't open " << absolutePath.toStdString() << std::endl;
+        return nullptr;
+    }
+    // Parse straight from the mapped pages instead of copying the file into a buffer first
+    qint64 length = file.size();
+    uchar* data = length > 0 ? file.map(0, length) : nullptr;
+    QJsonDocument document;
+    if (data != nullptr) {
+        document = QJsonDocument::fromJson(QByteArray::fromRawData((const char*) data, length));
+        file.unmap(data);
+    } else {
+        document = QJsonDocument::fromJson(file.readAll());
+    }
+    if (!document.isObject()) {
+        std::cout << "WorldLibrary: " << absolutePath.toStdString() << " is not a world file" << std::endl;
+        return nullptr;
+    }
+
+    auto world = std::make_shared<WorldRecord>(parse(document.object()));
+    world->id = info.completeBaseName().toStdString();
+    this->byPath[absolutePath.toStdString()] = world;
+    if (this->byId.find(world->id) == this->byId.end()) {
+        this->byId[world->id] = world;
+        this->ids.push_back(world->id);
+    }
+    return world;
+}
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,152 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/WumpusBehaviour.h"
+#include "model/GroundTile.h"
+#include "model/Model.h"
+
+#include <cstdlib>
+#include <limits>
+
+namespace wumpus_simulator
+{
+
+WumpusBehaviour::~WumpusBehaviour() {}
+
+std::shared_ptr<WumpusBehaviour> WumpusBehaviour::create(const std::string& name, unsigned int seed)
+{
+    if (name == "random") {
+        return std::make_shared<RandomWalkBehaviour>(seed);
+    } else if (name == "chase") {
+        return std::make_shared<ChaseBehaviour>();
+    } else if (name == "patrol") {
+        // Alternate between vertical and horizontal patrols
+        return std::make_shared<PatrolBehaviour>(seed % 2 == 0 ? WumpusEnums::heading::down : WumpusEnums::heading::right);
+    }
+    return nullptr;
+}
+
+bool WumpusBehaviour::isFree(Model* model, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= model->getPlayGroundSize() || y >= model->getPlayGroundSize()) {
+        return false;
+    }
+    auto tile = model->peekTile(x, y);
+    return !tile->getTrap() && !tile->hasWumpus();
+}
+
+void WumpusBehaviour::step(int direction, int& x, int& y)
+{
+    x += WumpusEnums::stepX(direction);
+    y += WumpusEnums::stepY(direction);
+}
+
+RandomWalkBehaviour::RandomWalkBehaviour(unsigned int seed)
+        : random(seed)
+{
+}
+
+int RandomWalkBehaviour::nextMove(EntityHandle wumpus, Model* model)
+{
+    int candidates[4];
+    int count = 0;
+    for (int direction = 0; direction < 4; direction++) {
+        int x = model->entities.getX(wumpus);
+        int y = model->entities.getY(wumpus);
+        step(direction, x, y);
+        if (isFree(model, x, y)) {
+            candidates[count++] = direction;
+        }
+    }
+    if (count == 0) {
+        return NO_MOVE;
+    }
+    return candidates[random() % count];
+}
+
+int ChaseBehaviour::nextMove(EntityHandle wumpus, Model* model)
+{
+    int x = model->entities.getX(wumpus);
+    int y = model->entities.getY(wumpus);
+    int bestDistance = std::numeric_limits<int>::max();
+    int targetX = x;
+    int targetY = y;
+    auto& entities = model->entities;
+    entities.forEach([&](EntityHandle entity) {
+        if (entities.getKind(entity) != EntityRegistry::agent) {
+            return;
+        }
+        int distance = std::abs(entities.getX(entity) - x) + std::abs(entities.getY(entity) - y);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            targetX = entities.getX(entity);
+            targetY = entities.getY(entity);
+        }
+    });
+    if (bestDistance == std::numeric_limits<int>::max()) {
+        return NO_MOVE;
+    }
+    int dx = targetX - x;
+    int dy = targetY - y;
+    int vertical = dx < 0 ? WumpusEnums::heading::up : WumpusEnums::heading::down;
+    int horizontal = dy < 0 ? WumpusEnums::heading::left : WumpusEnums::heading::right;
+    // Close the larger gap first and fall back to the other axis if blocked
+    bool verticalFirst = std::abs(dx) >= std::abs(dy);
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool useVertical = (attempt == 0) == verticalFirst;
+        if ((useVertical ? dx : dy) == 0) {
+            continue;
+        }
+        int direction = useVertical ? vertical : horizontal;
+        int nextX = x;
+        int nextY = y;
+        step(direction, nextX, nextY);
+        if (isFree(model, nextX, nextY)) {
+            return direction;
+        }
+    }
+    return NO_MOVE;
+}
+
+PatrolBehaviour::PatrolBehaviour(WumpusEnums::heading heading)
+{
+    this->heading = heading;
+}
+
+int PatrolBehaviour::nextMove(EntityHandle wumpus, Model* model)
+{
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int x = model->entities.getX(wumpus);
+        int y = model->entities.getY(wumpus);
+        step(this->heading, x, y);
+        if (isFree(model, x, y)) {
+            return this->heading;
+        }
+        // Turn around
+        this->heading = (WumpusEnums::heading)((this->heading + 2) % 4);
+    }
+    return NO_MOVE;
+}
+
+} /* namespace wumpus_simulator */
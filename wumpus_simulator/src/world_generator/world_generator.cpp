@@ -0,0 +1,213 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/Model.h"
+#include "model/WorldGenerator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using wumpus_simulator::Model;
+using wumpus_simulator::WorldGenerator;
+using wumpus_simulator::WorldLayout;
+
+/**
+ * Statistics of a single generated world that end up in the index manifest
+ */
+struct WorldStats
+{
+    QString file;
+    unsigned int seed;
+    int playGroundSize;
+    int trapCount;
+    int wumpusCount;
+    double hazardDensity;
+    int goldDistance;
+    bool written;
+};
+
+/**
+ * Parses "min:max" or a single value into a range
+ */
+static bool parseRange(const QString& value, int& min, int& max)
+{
+    auto parts = value.split(":");
+    bool okMin = false;
+    bool okMax = false;
+    min = parts.at(0).toInt(&okMin);
+    max = parts.size() > 1 ? parts.at(1).toInt(&okMax) : min;
+    if (parts.size() == 1) {
+        okMax = okMin;
+    }
+    return okMin && okMax && min <= max;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("wumpus_world_generator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates a set of wumpus world files (*.wwf) and an index manifest.");
+    parser.addHelpOption();
+    QCommandLineOption sizeOption("size", "Range of the field size (min:max).", "range", "4:8");
+    QCommandLineOption trapOption("traps", "Range of the number of traps (min:max).", "range", "1:4");
+    QCommandLineOption wumpusOption("wumpus", "Range of the number of wumpus (min:max).", "range", "1:2");
+    QCommandLineOption seedOption("seeds", "Range of seeds, one world per seed (first:last).", "range", "0:999");
+    QCommandLineOption outputOption("output", "Output directory.", "dir", ".");
+    QCommandLineOption threadOption("threads", "Number of worker threads, 0 uses all cores.", "count", "0");
+    QCommandLineOption arrowOption("arrow", "Agents have an arrow.");
+    QCommandLineOption solvableOption("solvable", "Skip worlds in which the gold cannot be reached safely.");
+    parser.addOption(sizeOption);
+    parser.addOption(trapOption);
+    parser.addOption(wumpusOption);
+    parser.addOption(seedOption);
+    parser.addOption(outputOption);
+    parser.addOption(threadOption);
+    parser.addOption(arrowOption);
+    parser.addOption(solvableOption);
+    parser.process(app);
+
+    int sizeMin, sizeMax, trapMin, trapMax, wumpusMin, wumpusMax, seedFirst, seedLast;
+    if (!parseRange(parser.value(sizeOption), sizeMin, sizeMax) || !parseRange(parser.value(trapOption), trapMin, trapMax) ||
+            !parseRange(parser.value(wumpusOption), wumpusMin, wumpusMax) || !parseRange(parser.value(seedOption), seedFirst, seedLast)) {
+        std::cerr << "wumpus_world_generator: invalid range, expected min:max" << std::endl;
+        return 1;
+    }
+    if (sizeMin < 2) {
+        std::cerr << "wumpus_world_generator: field size must be at least 2" << std::endl;
+        return 1;
+    }
+    QDir outputDir(parser.value(outputOption));
+    if (!outputDir.mkpath(".")) {
+        std::cerr << "wumpus_world_generator: cannot create output directory" << std::endl;
+        return 1;
+    }
+    int threadCount = parser.value(threadOption).toInt();
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    bool arrow = parser.isSet(arrowOption);
+    bool solvableOnly = parser.isSet(solvableOption);
+
+    int worldCount = seedLast - seedFirst + 1;
+    std::vector<WorldStats> stats(worldCount);
+    std::atomic<int> nextWorld(0);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.push_back(std::thread([&]() {
+            for (int i = nextWorld++; i < worldCount; i = nextWorld++) {
+                unsigned int seed = seedFirst + i;
+                // Dimensions are derived from the seed as well, so every world can be reproduced on its own
+                std::minstd_rand random(seed);
+                int size = sizeMin + random() % (sizeMax - sizeMin + 1);
+                int wumpus = wumpusMin + random() % (wumpusMax - wumpusMin + 1);
+                int traps = trapMin + random() % (trapMax - trapMin + 1);
+                // Random placement needs one tile left for the gold
+                int capacity = size * size - 1;
+                wumpus = std::min(wumpus, capacity);
+                traps = std::min(traps, capacity - wumpus);
+
+                WorldGenerator generator(wumpus, traps, size);
+                auto layout = generator.generate(seed);
+                auto& world = stats.at(i);
+                world.seed = seed;
+                world.playGroundSize = size;
+                world.trapCount = traps;
+                world.wumpusCount = wumpus;
+                world.hazardDensity = (double) (traps + wumpus) / (size * size);
+                world.goldDistance = generator.getGoldDistance(layout);
+                world.file = QString("world_%1.wwf").arg(seed);
+                world.written = !(solvableOnly && world.goldDistance < 0);
+                if (!world.written) {
+                    continue;
+                }
+
+                Model model;
+                model.setQuiet(true);
+                model.init(arrow, layout);
+                QFile file(outputDir.filePath(world.file));
+                if (!file.open(QIODevice::WriteOnly)) {
+                    std::cerr << "wumpus_world_generator: couldn't open " << world.file.toStdString() << std::endl;
+                    world.written = false;
+                    continue;
+                }
+                file.write(QJsonDocument(model.toJSON()).toJson(QJsonDocument::Compact));
+                file.close();
+            }
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Write index manifest
+    QJsonArray worlds;
+    int written = 0;
+    for (auto& world : stats) {
+        if (!world.written) {
+            continue;
+        }
+        QJsonObject entry;
+        entry["file"] = world.file;
+        entry["seed"] = (int) world.seed;
+        entry["playGroundSize"] = world.playGroundSize;
+        entry["trapCount"] = world.trapCount;
+        entry["wumpusCount"] = world.wumpusCount;
+        entry["agentHasArrow"] = arrow;
+        entry["hazardDensity"] = world.hazardDensity;
+        entry["goldDistance"] = world.goldDistance;
+        worlds.append(entry);
+        written++;
+    }
+    QJsonObject index;
+    index["worlds"] = worlds;
+    QFile indexFile(outputDir.filePath("index.json"));
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        std::cerr << "wumpus_world_generator: couldn't open index.json" << std::endl;
+        return 1;
+    }
+    indexFile.write(QJsonDocument(index).toJson());
+    indexFile.close();
+
+    std::cout << "wumpus_world_generator: wrote " << written << " of " << worldCount << " worlds on " << threadCount << " threads in " << elapsed.count()
+              << "s (" << (elapsed.count() > 0 ? worldCount / elapsed.count() : 0) << " worlds/s)" << std::endl;
+    return 0;
+}
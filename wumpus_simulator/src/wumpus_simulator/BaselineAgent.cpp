@@ -0,0 +1,270 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wumpus_simulator/BaselineAgent.h"
+
+#include <model/WumpusEnums.h>
+
+#include <algorithm>
+#include <deque>
+
+namespace wumpus_simulator
+{
+
+BaselineAgent::BaselineAgent()
+        : size(0)
+        , x(0)
+        , y(0)
+        , heading(WumpusEnums::heading::up)
+        , startX(0)
+        , startY(0)
+        , hasArrow(false)
+        , hasGold(false)
+        , alive(false)
+        , blocked(false)
+        , shiny(false)
+        , drafty(false)
+        , stinky(false)
+{
+}
+
+BaselineAgent::~BaselineAgent() {}
+
+std::unique_ptr<BaselineAgent> BaselineAgent::create(const std::string& name, unsigned int seed)
+{
+    if (name == "random") {
+        return std::unique_ptr<BaselineAgent>(new RandomAgent(seed));
+    } else if (name == "explorer") {
+        return std::unique_ptr<BaselineAgent>(new ExplorerAgent());
+    }
+    return nullptr;
+}
+
+void BaselineAgent::spawn(const InitialPoseResponse& pose)
+{
+    this->size = pose.fieldSize;
+    this->x = pose.x;
+    this->y = pose.y;
+    this->startX = pose.x;
+    this->startY = pose.y;
+    this->heading = pose.heading;
+    this->hasArrow = pose.hasArrow;
+    this->hasGold = false;
+    this->alive = true;
+    this->blocked = false;
+    this->shiny = false;
+    this->drafty = false;
+    this->stinky = false;
+}
+
+void BaselineAgent::perceive(const ActionResponse& response)
+{
+    if (!this->alive) {
+        return;
+    }
+    bool yourTurn = false;
+    for (auto r : response.responses) {
+        switch (r) {
+        case WumpusEnums::responses::goldFound:
+            this->hasGold = true;
+            break;
+        case WumpusEnums::responses::exited:
+        case WumpusEnums::responses::dead:
+        case WumpusEnums::responses::evicted:
+            this->alive = false;
+            return;
+        case WumpusEnums::responses::scream:
+        case WumpusEnums::responses::silence:
+            this->hasArrow = false;
+            break;
+        case WumpusEnums::responses::otherAgent:
+            this->blocked = true;
+            break;
+        case WumpusEnums::responses::yourTurn:
+            yourTurn = true;
+            break;
+        default:
+            break;
+        }
+    }
+    // Turn announcements always carry position and perception, other responses like timeouts do not
+    if (yourTurn) {
+        this->x = response.x;
+        this->y = response.y;
+        this->heading = response.heading;
+        this->shiny = std::find(response.responses.begin(), response.responses.end(), WumpusEnums::responses::shiny) != response.responses.end();
+        this->drafty = std::find(response.responses.begin(), response.responses.end(), WumpusEnums::responses::drafty) != response.responses.end();
+        this->stinky = std::find(response.responses.begin(), response.responses.end(), WumpusEnums::responses::stinky) != response.responses.end();
+    }
+}
+
+bool BaselineAgent::isAlive()
+{
+    return this->alive;
+}
+
+int BaselineAgent::walk(int direction)
+{
+    if (direction == this->heading) {
+        return WumpusEnums::actions::move;
+    }
+    // Turning left increases the heading, turning right decreases it
+    if (direction == (this->heading + 1) % 4) {
+        return WumpusEnums::actions::turnLeft;
+    }
+    return WumpusEnums::actions::turnRight;
+}
+
+RandomAgent::RandomAgent(unsigned int seed)
+        : random(seed)
+{
+}
+
+int RandomAgent::nextAction()
+{
+    if (!this->alive) {
+        return NO_ACTION;
+    }
+    if (this->shiny && !this->hasGold) {
+        return WumpusEnums::actions::pickUpGold;
+    }
+    if (this->hasGold && this->x == this->startX && this->y == this->startY) {
+        return WumpusEnums::actions::leave;
+    }
+    int candidates[4];
+    int count = 0;
+    int nextX = this->x + WumpusEnums::stepX(this->heading);
+    int nextY = this->y + WumpusEnums::stepY(this->heading);
+    if (!this->blocked && nextX >= 0 && nextY >= 0 && nextX < this->size && nextY < this->size) {
+        // Prefer moving over turning, otherwise the agent mostly spins in place
+        candidates[count++] = WumpusEnums::actions::move;
+        candidates[count++] = WumpusEnums::actions::move;
+    }
+    this->blocked = false;
+    candidates[count++] = WumpusEnums::actions::turnLeft;
+    candidates[count++] = WumpusEnums::actions::turnRight;
+    return candidates[this->random() % count];
+}
+
+void ExplorerAgent::spawn(const InitialPoseResponse& pose)
+{
+    BaselineAgent::spawn(pose);
+    this->known.clear();
+}
+
+void ExplorerAgent::perceive(const ActionResponse& response)
+{
+    BaselineAgent::perceive(response);
+    if (!this->alive || std::find(response.responses.begin(), response.responses.end(), WumpusEnums::responses::yourTurn) == response.responses.end()) {
+        return;
+    }
+    this->known[(int64_t) this->x * this->size + this->y] |= safe | visited;
+    if (this->drafty || this->stinky) {
+        return;
+    }
+    // Neither a trap nor a wumpus is next to this tile
+    for (int direction = 0; direction < 4; direction++) {
+        int nextX = this->x + WumpusEnums::stepX(direction);
+        int nextY = this->y + WumpusEnums::stepY(direction);
+        if (nextX >= 0 && nextY >= 0 && nextX < this->size && nextY < this->size) {
+            this->known[(int64_t) nextX * this->size + nextY] |= safe;
+        }
+    }
+}
+
+int ExplorerAgent::nextAction()
+{
+    if (!this->alive) {
+        return NO_ACTION;
+    }
+    if (this->blocked) {
+        // Step aside for the other agent instead of bumping into it every turn
+        this->blocked = false;
+        return WumpusEnums::actions::turnLeft;
+    }
+    if (this->shiny && !this->hasGold) {
+        return WumpusEnums::actions::pickUpGold;
+    }
+    int direction = -1;
+    if (this->hasGold) {
+        if (this->x == this->startX && this->y == this->startY) {
+            return WumpusEnums::actions::leave;
+        }
+        int64_t start = (int64_t) this->startX * this->size + this->startY;
+        direction = findPath([start](int64_t index, uint8_t flags) { return index == start; });
+    } else {
+        direction = findPath([](int64_t index, uint8_t flags) { return (flags & safe) && !(flags & visited); });
+        if (direction < 0) {
+            // Everything safe is explored, gamble on the closest unknown tile
+            direction = findPath([](int64_t index, uint8_t flags) { return !(flags & safe); });
+        }
+    }
+    if (direction < 0) {
+        // Nothing left to explore and no way out without the gold
+        return WumpusEnums::actions::turnLeft;
+    }
+    return walk(direction);
+}
+
+template <typename Goal>
+int ExplorerAgent::findPath(Goal goal)
+{
+    // Breadth first search over safe tiles, remembering the first step of every path
+    std::unordered_map<int64_t, int> firstStep;
+    std::deque<int64_t> queue;
+    int64_t origin = (int64_t) this->x * this->size + this->y;
+    firstStep[origin] = -1;
+    queue.push_back(origin);
+    while (!queue.empty()) {
+        int64_t current = queue.front();
+        queue.pop_front();
+        int currentX = current / this->size;
+        int currentY = current % this->size;
+        for (int direction = 0; direction < 4; direction++) {
+            int nextX = currentX + WumpusEnums::stepX(direction);
+            int nextY = currentY + WumpusEnums::stepY(direction);
+            if (nextX < 0 || nextY < 0 || nextX >= this->size || nextY >= this->size) {
+                continue;
+            }
+            int64_t next = (int64_t) nextX * this->size + nextY;
+            if (firstStep.count(next) != 0) {
+                continue;
+            }
+            auto it = this->known.find(next);
+            uint8_t flags = it == this->known.end() ? 0 : it->second;
+            int first = current == origin ? direction : firstStep[current];
+            if (goal(next, flags)) {
+                return first;
+            }
+            // Unknown tiles may be goals but are never walked through
+            if (flags & safe) {
+                firstStep[next] = first;
+                queue.push_back(next);
+            }
+        }
+    }
+    return -1;
+}
+
+} /* namespace wumpus_simulator */
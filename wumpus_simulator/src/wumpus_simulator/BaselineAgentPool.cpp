@@ -0,0 +1,203 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wumpus_simulator/BaselineAgentPool.h"
+
+#include <model/WumpusEnums.h>
+
+#include <algorithm>
+
+namespace wumpus_simulator
+{
+
+BaselineAgentPool::BaselineAgentPool()
+{
+    this->stopping = false;
+}
+
+BaselineAgentPool::~BaselineAgentPool()
+{
+    stop();
+}
+
+void BaselineAgentPool::add(int id, std::unique_ptr<BaselineAgent> agent)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    Slot& slot = this->agents[id];
+    slot.agent = std::move(agent);
+    slot.scheduled = false;
+}
+
+void BaselineAgentPool::start(int threads, ActionCallback callback)
+{
+    if (this->agents.empty() || !this->workers.empty()) {
+        return;
+    }
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // More workers than agents would never get any work
+    threads = std::min<int>(threads, this->agents.size());
+    this->callback = callback;
+    this->stopping = false;
+    for (int i = 0; i < threads; i++) {
+        this->workers.push_back(std::thread(&BaselineAgentPool::run, this));
+    }
+}
+
+void BaselineAgentPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wakeup.notify_all();
+    for (auto& worker : this->workers) {
+        worker.join();
+    }
+    this->workers.clear();
+}
+
+bool BaselineAgentPool::contains(int id)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->agents.find(id) != this->agents.end();
+}
+
+bool BaselineAgentPool::empty()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->agents.empty();
+}
+
+std::vector<int> BaselineAgentPool::getIds()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::vector<int> ids;
+    for (auto& slot : this->agents) {
+        ids.push_back(slot.first);
+    }
+    return ids;
+}
+
+void BaselineAgentPool::spawn(const InitialPoseResponse& pose)
+{
+    Event event;
+    event.spawn = true;
+    event.pose = pose;
+    enqueue(pose.agentId, std::move(event));
+}
+
+void BaselineAgentPool::deliver(const ActionResponse& response)
+{
+    Event event;
+    event.spawn = false;
+    event.response = response;
+    enqueue(response.agentId, std::move(event));
+}
+
+void BaselineAgentPool::enqueue(int id, Event&& event)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto it = this->agents.find(id);
+        if (it == this->agents.end()) {
+            return;
+        }
+        it->second.inbox.push_back(std::move(event));
+        if (it->second.scheduled) {
+            // The worker that owns the agent picks the event up when it is done
+            return;
+        }
+        it->second.scheduled = true;
+        this->ready.push_back(id);
+    }
+    this->wakeup.notify_one();
+}
+
+bool BaselineAgentPool::isTurn(const ActionResponse& response)
+{
+    return std::find(response.responses.begin(), response.responses.end(), WumpusEnums::responses::yourTurn) != response.responses.end();
+}
+
+void BaselineAgentPool::run()
+{
+    std::deque<Event> events;
+    while (true) {
+        int id;
+        Slot* slot;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wakeup.wait(lock, [this] { return !this->ready.empty() || this->stopping; });
+            if (this->stopping) {
+                return;
+            }
+            id = this->ready.front();
+            this->ready.pop_front();
+            slot = &this->agents[id];
+            events.swap(slot->inbox);
+        }
+
+        // A turn that was followed by a respawn or another turn is outdated, only the last one is played
+        size_t last = events.size();
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events[i].spawn || isTurn(events[i].response)) {
+                last = i;
+            }
+        }
+
+        // Only this worker touches the agent until it is rescheduled
+        for (size_t i = 0; i < events.size(); i++) {
+            auto& event = events[i];
+            if (event.spawn) {
+                slot->agent->spawn(event.pose);
+                continue;
+            }
+            slot->agent->perceive(event.response);
+            if (i != last || !isTurn(event.response)) {
+                continue;
+            }
+            int action = slot->agent->nextAction();
+            if (action != BaselineAgent::NO_ACTION) {
+                ActionRequestPtr request(new ActionRequest());
+                request->agentId = id;
+                request->action = action;
+                this->callback(request);
+            }
+        }
+        events.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (slot->inbox.empty()) {
+                slot->scheduled = false;
+            } else {
+                this->ready.push_back(id);
+                this->wakeup.notify_one();
+            }
+        }
+    }
+}
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,186 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wumpus_simulator/Checkpointer.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+
+namespace wumpus_simulator
+{
+
+Checkpointer::Checkpointer()
+{
+    this->stopping = false;
+    this->hasPending = false;
+    this->imageResetCount = 0;
+    this->pending.resetCount = 0;
+    this->pending.turnIndex = 0;
+}
+
+Checkpointer::~Checkpointer()
+{
+    if (this->worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->wakeup.notify_one();
+        this->worker.join();
+    }
+}
+
+void Checkpointer::configure(const std::string& path)
+{
+    this->path = path;
+    if (!path.empty() && !this->worker.joinable()) {
+        this->worker = std::thread(&Checkpointer::run, this);
+    }
+}
+
+bool Checkpointer::isEnabled()
+{
+    return !this->path.empty();
+}
+
+const std::string& Checkpointer::getPath()
+{
+    return this->path;
+}
+
+void Checkpointer::add(uint32_t resetCount, WorldRecord&& changes)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->pending.resetCount == resetCount) {
+        // Later tiles win when the changes are applied in order
+        auto& tiles = this->pending.changes.tiles;
+        tiles.insert(tiles.end(), changes.tiles.begin(), changes.tiles.end());
+        changes.tiles = std::move(tiles);
+    }
+    this->pending.changes = std::move(changes);
+    this->pending.resetCount = resetCount;
+}
+
+void Checkpointer::submit(const std::vector<int>& turns, int turnIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->pending.turns = turns;
+        this->pending.turnIndex = turnIndex;
+        this->hasPending = true;
+    }
+    this->wakeup.notify_one();
+}
+
+void Checkpointer::run()
+{
+    Pending checkpoint;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wakeup.wait(lock, [this] { return this->hasPending || this->stopping; });
+            if (!this->hasPending) {
+                return;
+            }
+            std::swap(checkpoint, this->pending);
+            // Changes added from now on belong to the next checkpoint
+            this->pending.changes.tiles.clear();
+            this->pending.resetCount = checkpoint.resetCount;
+            this->hasPending = false;
+        }
+        if (!write(checkpoint)) {
+            std::cout << "Checkpointer: couldn't write " << this->path << std::endl;
+        }
+    }
+}
+
+bool Checkpointer::write(Pending& checkpoint)
+{
+    // A reset of the playground invalidates all tiles of the image
+    if (checkpoint.resetCount != this->imageResetCount) {
+        this->image.clear();
+        this->imageResetCount = checkpoint.resetCount;
+    }
+    int64_t size = checkpoint.changes.playGroundSize;
+    for (auto& tile : checkpoint.changes.tiles) {
+        this->image[tile.x * size + tile.y] = tile;
+    }
+
+    WorldRecord world = checkpoint.changes;
+    world.tiles.clear();
+    world.tiles.reserve(this->image.size());
+    for (auto& entry : this->image) {
+        world.tiles.push_back(entry.second);
+    }
+    QJsonObject root = WorldLibrary::serialize(world);
+    QJsonArray turns;
+    for (int id : checkpoint.turns) {
+        turns.append(id);
+    }
+    root["turns"] = turns;
+    root["turnIndex"] = checkpoint.turnIndex;
+    QByteArray data = QJsonDocument(root).toJson(QJsonDocument::Compact);
+
+    // The previous checkpoint stays intact until the new one is on disk
+    std::string tmpPath = this->path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = fwrite(data.constData(), 1, data.size(), file) == (size_t) data.size();
+    written = fflush(file) == 0 && fsync(fileno(file)) == 0 && written;
+    if (fclose(file) != 0 || !written) {
+        return false;
+    }
+    return std::rename(tmpPath.c_str(), this->path.c_str()) == 0;
+}
+
+bool Checkpointer::read(const std::string& path, WorldRecord& world, std::vector<int>& turns, int& turnIndex)
+{
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    if (!document.isObject() || !document.object().contains("turns")) {
+        return false;
+    }
+    QJsonObject root = document.object();
+    world = WorldLibrary::parse(root);
+    turns.clear();
+    QJsonArray order = root["turns"].toArray();
+    for (int i = 0; i < order.size(); i++) {
+        turns.push_back(order.at(i).toInt());
+    }
+    turnIndex = root["turnIndex"].toInt();
+    return true;
+}
+
+} /* namespace wumpus_simulator */
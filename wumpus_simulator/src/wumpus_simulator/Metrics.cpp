@@ -0,0 +1,111 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wumpus_simulator/Metrics.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace wumpus_simulator
+{
+
+namespace
+{
+struct MetricInfo
+{
+    const char* name;
+    const char* help;
+};
+
+const MetricInfo counterInfo[Metrics::COUNTER_COUNT] = {
+        {"wumpus_actions_total", "Actions handled by the simulator"},
+        {"wumpus_rejected_actions_total", "Actions rejected because it was not the sender's turn"},
+        {"wumpus_spawns_total", "Agents placed on the field"},
+        {"wumpus_deaths_total", "Agents killed by traps or wumpus"},
+        {"wumpus_exits_total", "Agents that left the field with the gold"},
+        {"wumpus_killed_wumpus_total", "Wumpus killed by arrows"},
+        {"wumpus_turn_timeouts_total", "Turns that missed their deadline"},
+        {"wumpus_evictions_total", "Agents evicted after repeated timeouts"},
+        {"wumpus_renders_total", "Redraws of the playground"},
+        {"wumpus_render_microseconds_total", "Time spent redrawing the playground"},
+};
+
+const MetricInfo gaugeInfo[Metrics::GAUGE_COUNT] = {
+        {"wumpus_live_agents", "Agents currently on the field"},
+        {"wumpus_live_wumpus", "Wumpus currently on the field"},
+        {"wumpus_pending_actions", "Action requests waiting for the simulation"},
+        {"wumpus_last_render_microseconds", "Duration of the last redraw of the playground"},
+};
+} // namespace
+
+Metrics* Metrics::get()
+{
+    static Metrics instance;
+    return &instance;
+}
+
+Metrics::Metrics()
+{
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        counters[i].store(0);
+    }
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        gauges[i].store(0);
+    }
+}
+
+std::string Metrics::toPrometheus()
+{
+    std::ostringstream out;
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        out << "# HELP " << counterInfo[i].name << " " << counterInfo[i].help << "\n";
+        out << "# TYPE " << counterInfo[i].name << " counter\n";
+        out << counterInfo[i].name << " " << get((counter) i) << "\n";
+    }
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        out << "# HELP " << gaugeInfo[i].name << " " << gaugeInfo[i].help << "\n";
+        out << "# TYPE " << gaugeInfo[i].name << " gauge\n";
+        out << gaugeInfo[i].name << " " << get((gauge) i) << "\n";
+    }
+    return out.str();
+}
+
+bool Metrics::writePrometheus(const std::string& path)
+{
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath.c_str(), std::ios::out | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << toPrometheus();
+        if (!file) {
+            return false;
+        }
+    }
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,302 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wumpus_simulator/ScoreBoard.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+namespace wumpus_simulator
+{
+
+ScoreBoard::ScoreBoard()
+{
+    this->binary = false;
+    this->flushEpisodes = 1;
+    this->world = Record();
+    this->episodeCount = 0;
+    this->episodeStartMicros = nowMicros();
+    this->playingCount = 0;
+    this->over = false;
+    this->pendingEpisodes = 0;
+}
+
+ScoreBoard::~ScoreBoard()
+{
+    flush();
+}
+
+void ScoreBoard::configure(const std::string& path, const std::string& format, int flushEpisodes)
+{
+    this->path = path;
+    this->binary = format == "binary";
+    this->flushEpisodes = std::max(flushEpisodes, 1);
+}
+
+void ScoreBoard::beginEpisode(uint32_t seed, int playGroundSize, int wumpusCount, int trapCount)
+{
+    if (!this->agents.empty()) {
+        for (auto& entry : this->agents) {
+            if (entry.second.record.outcome == playing) {
+                entry.second.record.outcome = aborted;
+                entry.second.record.agentMicros = nowMicros() - entry.second.spawnMicros;
+            }
+        }
+        endEpisode();
+    }
+    this->world = Record();
+    this->world.seed = seed;
+    this->world.playGroundSize = playGroundSize;
+    this->world.wumpusCount = wumpusCount;
+    this->world.trapCount = trapCount;
+    this->episodeStartMicros = nowMicros();
+    this->playingCount = 0;
+    this->over = false;
+}
+
+void ScoreBoard::spawn(int agentId)
+{
+    if (this->agents.empty()) {
+        // First agent of the episode, agents that join a finished world start a new one
+        this->episodeStartMicros = nowMicros();
+    }
+    auto it = this->agents.find(agentId);
+    if (it != this->agents.end()) {
+        // The agent respawns in the same episode, a finished life keeps its own record
+        if (it->second.record.outcome == playing) {
+            this->playingCount--;
+        } else {
+            this->finished.push_back(it->second.record);
+        }
+    }
+    AgentState& state = this->agents[agentId];
+    state.record = this->world;
+    state.record.agentId = agentId;
+    state.record.outcome = playing;
+    state.spawnMicros = nowMicros();
+    this->playingCount++;
+    this->over = false;
+}
+
+void ScoreBoard::turn(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.turns++;
+    }
+}
+
+void ScoreBoard::step(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.steps++;
+    }
+}
+
+void ScoreBoard::bump(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.bumps++;
+    }
+}
+
+void ScoreBoard::rotate(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.rotations++;
+    }
+}
+
+void ScoreBoard::shot(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.arrowsShot++;
+    }
+}
+
+void ScoreBoard::kill(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.wumpusKilled++;
+    }
+}
+
+void ScoreBoard::gold(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.hasGold = 1;
+    }
+}
+
+void ScoreBoard::timeout(int agentId)
+{
+    auto state = getAgent(agentId);
+    if (state != nullptr) {
+        state->record.timeouts++;
+    }
+}
+
+bool ScoreBoard::finish(int agentId, outcome result)
+{
+    // Only playing agents are returned, an agent cannot finish twice
+    auto state = getAgent(agentId);
+    if (state == nullptr) {
+        return false;
+    }
+    state->record.outcome = result;
+    state->record.agentMicros = nowMicros() - state->spawnMicros;
+    this->playingCount--;
+    if (this->playingCount == 0) {
+        endEpisode();
+        return true;
+    }
+    return false;
+}
+
+bool ScoreBoard::isEpisodeOver()
+{
+    return this->over;
+}
+
+uint32_t ScoreBoard::getEpisodeCount()
+{
+    return this->episodeCount;
+}
+
+ScoreBoard::AgentState* ScoreBoard::getAgent(int agentId)
+{
+    auto it = this->agents.find(agentId);
+    if (it == this->agents.end() || it->second.record.outcome != playing) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void ScoreBoard::endEpisode()
+{
+    this->episodeCount++;
+    uint64_t episodeMicros = nowMicros() - this->episodeStartMicros;
+    if (!this->path.empty()) {
+        for (auto& record : this->finished) {
+            record.episode = this->episodeCount;
+            record.episodeMicros = episodeMicros;
+            this->pending.push_back(record);
+        }
+        for (auto& entry : this->agents) {
+            entry.second.record.episode = this->episodeCount;
+            entry.second.record.episodeMicros = episodeMicros;
+            this->pending.push_back(entry.second.record);
+        }
+        this->pendingEpisodes++;
+    }
+    this->agents.clear();
+    this->finished.clear();
+    this->playingCount = 0;
+    this->over = true;
+    if (this->pendingEpisodes >= this->flushEpisodes) {
+        flush();
+    }
+}
+
+bool ScoreBoard::flush()
+{
+    if (this->pending.empty() || this->path.empty()) {
+        return true;
+    }
+    bool written = this->binary ? writeBinary() : writeCSV();
+    if (!written) {
+        std::cout << "ScoreBoard: couldn't write results to " << this->path << std::endl;
+    }
+    this->pending.clear();
+    this->pendingEpisodes = 0;
+    return written;
+}
+
+bool ScoreBoard::writeCSV()
+{
+    FILE* file = fopen(this->path.c_str(), "a");
+    if (file == nullptr) {
+        return false;
+    }
+    std::ostringstream out;
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        out << "episode,seed,size,wumpus,traps,agent,turns,steps,bumps,rotations,arrows,kills,timeouts,gold,outcome,agent_ms,episode_ms\n";
+    }
+    for (auto& record : this->pending) {
+        out << record.episode << ',' << record.seed << ',' << record.playGroundSize << ',' << record.wumpusCount << ',' << record.trapCount << ','
+            << record.agentId << ',' << record.turns << ',' << record.steps << ',' << record.bumps << ',' << record.rotations << ','
+            << record.arrowsShot << ',' << record.wumpusKilled << ',' << record.timeouts << ',' << (int) record.hasGold << ','
+            << getOutcomeName(record.outcome) << ',' << record.agentMicros / 1000.0 << ',' << record.episodeMicros / 1000.0 << '\n';
+    }
+    std::string data = out.str();
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && written;
+}
+
+bool ScoreBoard::writeBinary()
+{
+    FILE* file = fopen(this->path.c_str(), "ab");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = fwrite(this->pending.data(), sizeof(Record), this->pending.size(), file) == this->pending.size();
+    return fclose(file) == 0 && written;
+}
+
+const char* ScoreBoard::getOutcomeName(uint8_t result)
+{
+    switch (result) {
+    case playing:
+        return "playing";
+    case exited:
+        return "exited";
+    case trap:
+        return "trap";
+    case eaten:
+        return "wumpus";
+    case evicted:
+        return "evicted";
+    case aborted:
+        return "aborted";
+    default:
+        return "unknown";
+    }
+}
+
+uint64_t ScoreBoard::nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} /* namespace wumpus_simulator */
@@ -0,0 +1,127 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wumpus_simulator/Tracer.h"
+
+#include <chrono>
+#include <fstream>
+#include <unistd.h>
+
+namespace wumpus_simulator
+{
+
+Tracer* Tracer::get()
+{
+    static Tracer instance;
+    return &instance;
+}
+
+Tracer::Tracer()
+{
+    this->enabled.store(false);
+    this->next.store(0);
+    this->capacity = 0;
+}
+
+void Tracer::enable(size_t capacity)
+{
+    // Buffer is only allocated once, resizing while spans are recorded is not safe
+    if (this->events == nullptr && capacity > 0) {
+        this->capacity = capacity;
+        this->events.reset(new Event[capacity]);
+        for (size_t i = 0; i < capacity; i++) {
+            this->events[i].sequence.store(0);
+        }
+    }
+    this->enabled.store(this->events != nullptr);
+}
+
+void Tracer::disable()
+{
+    this->enabled.store(false);
+}
+
+void Tracer::record(const char* name, uint64_t startMicros, uint64_t endMicros)
+{
+    if (this->events == nullptr) {
+        return;
+    }
+    uint64_t index = this->next.fetch_add(1, std::memory_order_relaxed);
+    Event& event = this->events[index % this->capacity];
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.start = startMicros;
+    event.duration = endMicros - startMicros;
+    event.threadId = currentThreadId();
+    event.sequence.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::flush(const std::string& path)
+{
+    if (this->events == nullptr) {
+        return false;
+    }
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    int pid = getpid();
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    uint64_t end = this->next.load(std::memory_order_acquire);
+    uint64_t begin = end > this->capacity ? end - this->capacity : 0;
+    for (uint64_t index = begin; index < end; index++) {
+        Event& event = this->events[index % this->capacity];
+        // Copy the slot and drop it if it was overwritten in the meantime
+        uint64_t sequence = event.sequence.load(std::memory_order_acquire);
+        const char* name = event.name;
+        uint64_t start = event.start;
+        uint64_t duration = event.duration;
+        int threadId = event.threadId;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence != index + 1 || event.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        file << (first ? "" : ",") << "\n{\"name\":\"" << name << "\",\"cat\":\"wumpus\",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << duration
+             << ",\"pid\":" << pid << ",\"tid\":" << threadId << "}";
+        first = false;
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+uint64_t Tracer::nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int Tracer::currentThreadId()
+{
+    static std::atomic<int> nextThreadId(1);
+    static thread_local int threadId = nextThreadId.fetch_add(1);
+    return threadId;
+}
+
+} /* namespace wumpus_simulator */
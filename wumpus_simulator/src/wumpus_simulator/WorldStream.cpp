@@ -0,0 +1,128 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wumpus_simulator/WorldStream.h"
+
+#include <model/EntityRegistry.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace wumpus_simulator
+{
+
+WorldStream::WorldStream()
+{
+    this->enabled = false;
+    this->keyframeInterval = 0;
+    this->sinceKeyframe = 0;
+    this->keyframeRequested = true;
+    this->lastResetCount = 0;
+    this->sequence = 0;
+}
+
+WorldStream::~WorldStream() {}
+
+void WorldStream::configure(bool enabled, int keyframeInterval)
+{
+    this->enabled = enabled;
+    this->keyframeInterval = std::max(keyframeInterval, 0);
+}
+
+bool WorldStream::isEnabled()
+{
+    return this->enabled;
+}
+
+bool WorldStream::needsKeyframe(uint32_t resetCount)
+{
+    return this->keyframeRequested || resetCount != this->lastResetCount ||
+           (this->keyframeInterval > 0 && this->sinceKeyframe >= this->keyframeInterval);
+}
+
+void WorldStream::requestKeyframe()
+{
+    this->keyframeRequested = true;
+}
+
+void WorldStream::encode(uint32_t resetCount, const WorldRecord& world, bool keyframe, WorldDelta& msg)
+{
+    msg.sequence = this->sequence++;
+    msg.keyframe = keyframe;
+    msg.playGroundSize = world.playGroundSize;
+    msg.seed = world.seed;
+    if (keyframe) {
+        this->keyframeRequested = false;
+        this->lastResetCount = resetCount;
+        this->sinceKeyframe = 0;
+    } else {
+        this->sinceKeyframe++;
+    }
+
+    // Changed tiles come in the order they were touched
+    std::vector<std::pair<uint64_t, const WorldTile*>> tiles;
+    tiles.reserve(world.tiles.size());
+    for (auto& tile : world.tiles) {
+        tiles.push_back(std::make_pair((uint64_t) tile.x * world.playGroundSize + tile.y, &tile));
+    }
+    std::sort(tiles.begin(), tiles.end(),
+            [](const std::pair<uint64_t, const WorldTile*>& a, const std::pair<uint64_t, const WorldTile*>& b) { return a.first < b.first; });
+
+    for (auto& entry : tiles) {
+        uint8_t state = getState(*entry.second);
+        // Keyframes leave out plain dirt, deltas need it for tiles that became dirt
+        if (keyframe && state == 0) {
+            continue;
+        }
+        size_t runs = msg.runStart.size();
+        if (runs > 0 && msg.runStart[runs - 1] + msg.runLength[runs - 1] == entry.first && msg.runState[runs - 1] == state) {
+            msg.runLength[runs - 1]++;
+        } else {
+            msg.runStart.push_back(entry.first);
+            msg.runLength.push_back(1);
+            msg.runState.push_back(state);
+        }
+        if (entry.second->entity != EntityRegistry::none) {
+            msg.entityId.push_back(entry.second->agentId);
+            msg.entityTile.push_back(entry.first);
+            msg.entityHeading.push_back(entry.second->agentHeading);
+        }
+    }
+}
+
+uint8_t WorldStream::getState(const WorldTile& tile)
+{
+    uint8_t state = 0;
+    state |= tile.trap ? trapBit : 0;
+    state |= tile.gold ? goldBit : 0;
+    state |= tile.stench ? stenchBit : 0;
+    state |= tile.breeze ? breezeBit : 0;
+    state |= tile.startpoint ? startpointBit : 0;
+    state |= tile.entity == EntityRegistry::wumpus ? wumpusBit : 0;
+    state |= tile.entity == EntityRegistry::agent ? agentBit : 0;
+    return state;
+}
+
+} /* namespace wumpus_simulator */
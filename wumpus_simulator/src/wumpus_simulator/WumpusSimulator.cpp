@@ -1,11 +1,16 @@
 #include "wumpus_simulator/WumpusSimulator.h"
+#include "wumpus_simulator/Metrics.h"
+#include "wumpus_simulator/RuleSet.h"
+#include "wumpus_simulator/Tracer.h"
 
-#include "model/Agent.h"
 #include "model/GroundTile.h"
+#include "model/KnowledgeMap.h"
 #include "model/Model.h"
-#include "model/Movable.h"
-#include "model/Wumpus.h"
+#include "model/WumpusBehaviour.h"
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QUrl>
 #include <QtNetwork/qnetworkproxy.h>
 #include <QtWebKitWidgets/qwebframe.h>
@@ -17,10 +22,38 @@
 #include <pluginlib/class_list_macros.h>
 #include <ros/master.h>
 
+#include <chrono>
+#include <climits>
+#include <cstdio>
 #include <memory>
+#include <unordered_set>
 
 namespace wumpus_simulator
 {
+
+namespace
+{
+/**
+ * Responses for every perception mask, always in the order shiny, drafty, stinky
+ */
+struct PerceptionResponses
+{
+    int count;
+    int32_t responses[3];
+};
+
+const PerceptionResponses perceptionTable[8] = {
+        {0, {}},
+        {1, {WumpusEnums::responses::shiny}},
+        {1, {WumpusEnums::responses::drafty}},
+        {2, {WumpusEnums::responses::shiny, WumpusEnums::responses::drafty}},
+        {1, {WumpusEnums::responses::stinky}},
+        {2, {WumpusEnums::responses::shiny, WumpusEnums::responses::stinky}},
+        {2, {WumpusEnums::responses::drafty, WumpusEnums::responses::stinky}},
+        {3, {WumpusEnums::responses::shiny, WumpusEnums::responses::drafty, WumpusEnums::responses::stinky}},
+};
+} // namespace
+
 WumpusSimulator::WumpusSimulator()
         : rqt_gui_cpp::Plugin()
         , widget_(0)
@@ -28,19 +61,164 @@ WumpusSimulator::WumpusSimulator()
     setObjectName("WumpusSimulator");
     this->model = nullptr;
     turnIndex = 0;
+    this->viewRow = 0;
+    this->viewCol = 0;
+    this->viewRows = 0;
+    this->viewCols = 0;
+    this->overviewBlock = 0;
+    useRules<ClassicRules>();
 
     spawnAgentSub = n.subscribe("/wumpus_simulator/SpawnAgentRequest", 10, &WumpusSimulator::onSpawnAgent, (WumpusSimulator*) this);
+    spawnAgentsSub = n.subscribe("/wumpus_simulator/SpawnAgentsRequest", 10, &WumpusSimulator::onSpawnAgents, (WumpusSimulator*) this);
     actionSub = n.subscribe("/wumpus_simulator/ActionRequest", 10, &WumpusSimulator::onAction, (WumpusSimulator*) this);
 
     spawnAgentPub = n.advertise<wumpus_simulator::InitialPoseResponse>("/wumpus_simulator/SpawnAgentResponse", 10);
+    spawnAgentsPub = n.advertise<wumpus_simulator::SpawnAgentsResponse>("/wumpus_simulator/SpawnAgentsResponse", 10);
     actionPub = n.advertise<wumpus_simulator::ActionResponse>("/wumpus_simulator/ActionResponse", 10);
+    statsPub = n.advertise<wumpus_simulator::SimulatorStats>("/wumpus_simulator/Stats", 10);
+    deltaPub = n.advertise<wumpus_simulator::WorldDelta>("/wumpus_simulator/WorldDelta", 10);
+
+    // Periodic export of the metrics, disabled if the period is not positive
+    double metricsPeriod;
+    n.param<double>("/wumpus_simulator/metrics_period", metricsPeriod, 1.0);
+    n.param<std::string>("/wumpus_simulator/metrics_file", metricsFile, "");
+    lastMetricsActions = 0;
+    lastMetricsTime = ros::WallTime::now();
+    if (metricsPeriod > 0) {
+        metricsTimer = n.createWallTimer(ros::WallDuration(metricsPeriod), &WumpusSimulator::onMetricsTimer, this);
+    }
+
+    // Turn deadline, disabled if the timeout is not positive
+    n.param<double>("/wumpus_simulator/turn_timeout", turnTimeout, 0.0);
+    n.param<int>("/wumpus_simulator/turn_timeout_penalty", timeoutPenalty, 0);
+    n.param<int>("/wumpus_simulator/max_timeouts", maxTimeouts, 3);
+    this->turnDeadlineArmed = false;
+    if (turnTimeout > 0) {
+        // Polls instead of being re-armed per turn, stopping a timer under the simulation lock
+        // waits for its running callback, which may itself wait for the lock
+        turnTimer = n.createWallTimer(ros::WallDuration(turnTimeout / TURN_DEADLINE_CHECKS), &WumpusSimulator::onTurnDeadline, this);
+    }
+
+    // Opt-in tracing of the action pipeline
+    int traceBufferSize;
+    n.param<int>("/wumpus_simulator/trace_buffer_size", traceBufferSize, 0);
+    n.param<std::string>("/wumpus_simulator/trace_file", traceFile, "wumpus_trace.json");
+    if (traceBufferSize > 0) {
+        Tracer::get()->enable(traceBufferSize);
+        flushTraceSub = n.subscribe("/wumpus_simulator/FlushTrace", 1, &WumpusSimulator::onFlushTrace, (WumpusSimulator*) this);
+    }
+
+    // Episode results, disabled if no file is given
+    std::string scoreFile;
+    std::string scoreFormat;
+    int scoreFlushEpisodes;
+    n.param<std::string>("/wumpus_simulator/score_file", scoreFile, "");
+    n.param<std::string>("/wumpus_simulator/score_format", scoreFormat, "csv");
+    n.param<int>("/wumpus_simulator/score_flush_episodes", scoreFlushEpisodes, 1);
+    this->scores.configure(scoreFile, scoreFormat, scoreFlushEpisodes);
+
+    // Fingerprint of the world in every response, e.g. to compare runs
+    n.param<bool>("/wumpus_simulator/hash_responses", hashResponses, false);
+    // Lets agents mask actions that would be rejected without asking the simulator
+    n.param<bool>("/wumpus_simulator/legal_action_masks", legalActionMasks, false);
+
+    // Automatic reset when an episode is over, worlds come from an index or a seed schedule
+    std::string resetIndex;
+    std::string resetSeeds;
+    n.param<bool>("/wumpus_simulator/auto_reset", autoReset, false);
+    n.param<int>("/wumpus_simulator/auto_reset_episodes", autoResetEpisodes, 0);
+    n.param<std::string>("/wumpus_simulator/auto_reset_index", resetIndex, "");
+    n.param<std::string>("/wumpus_simulator/auto_reset_seeds", resetSeeds, "");
+    this->nextResetWorld = 0;
+    this->nextResetSeed = 0;
+    this->lastResetSeed = UINT_MAX;
+    this->hasResetSeeds = false;
+    if (!resetSeeds.empty()) {
+        int parsed = sscanf(resetSeeds.c_str(), "%u:%u", &this->nextResetSeed, &this->lastResetSeed);
+        if (parsed < 1) {
+            std::cout << "WumpusSimulator: invalid auto_reset_seeds " << resetSeeds << ", expected first:last" << std::endl;
+        }
+        this->hasResetSeeds = parsed >= 1;
+    }
 
+    // World files are decoded once, switching worlds afterwards only applies the cached records
+    std::string worldLibrary;
+    std::string startWorld;
+    n.param<std::string>("/wumpus_simulator/world_library", worldLibrary, "");
+    n.param<std::string>("/wumpus_simulator/world", startWorld, "");
+    if (!worldLibrary.empty()) {
+        this->worlds.preload(QString::fromStdString(worldLibrary));
+    }
+    if (!resetIndex.empty()) {
+        // The reset schedule plays the worlds of the index in its order, including worlds the library already holds
+        this->resetWorlds = this->worlds.preload(QString::fromStdString(resetIndex));
+    }
+    loadWorldService = n.advertiseService("/wumpus_simulator/LoadWorld", &WumpusSimulator::onLoadWorld, this);
+
+    // Periodic checkpoints, disabled if no file is given
+    std::string checkpointFile;
+    double checkpointPeriod;
+    bool resume;
+    n.param<std::string>("/wumpus_simulator/checkpoint_file", checkpointFile, "");
+    n.param<double>("/wumpus_simulator/checkpoint_period", checkpointPeriod, 10.0);
+    n.param<bool>("/wumpus_simulator/resume", resume, false);
+    this->checkpoints.configure(checkpointFile);
+    if (this->checkpoints.isEnabled() && checkpointPeriod > 0) {
+        checkpointTimer = n.createWallTimer(ros::WallDuration(checkpointPeriod), &WumpusSimulator::onCheckpointTimer, this);
+    }
+
+    // World delta stream, disabled if the period is not positive
+    double deltaPeriod;
+    int keyframeInterval;
+    n.param<double>("/wumpus_simulator/delta_period", deltaPeriod, 0.0);
+    n.param<int>("/wumpus_simulator/delta_keyframe_interval", keyframeInterval, 100);
+    this->worldStream.configure(deltaPeriod > 0, keyframeInterval);
+    if (deltaPeriod > 0) {
+        deltaTimer = n.createWallTimer(ros::WallDuration(deltaPeriod), &WumpusSimulator::onDeltaTimer, this);
+    }
+
+    // Reference agents inside the simulator, they take part in every world like registered agents
+    int randomAgents;
+    int explorerAgents;
+    int baselineThreads;
+    int baselineFirstId;
+    n.param<int>("/wumpus_simulator/baseline_random_agents", randomAgents, 0);
+    n.param<int>("/wumpus_simulator/baseline_explorer_agents", explorerAgents, 0);
+    n.param<int>("/wumpus_simulator/baseline_threads", baselineThreads, 0);
+    n.param<int>("/wumpus_simulator/baseline_first_id", baselineFirstId, 1000);
+    for (int i = 0; i < randomAgents + explorerAgents; i++) {
+        int id = baselineFirstId + i;
+        this->baselineAgents.add(id, BaselineAgent::create(i < randomAgents ? "random" : "explorer", id));
+        this->registered.push_back(id);
+    }
+    this->baselineAgents.start(baselineThreads, [this](ActionRequestPtr msg) { this->onAction(msg); });
+
+    // Autonomous wumpus of huge worlds are resolved region by region on several threads
+    int moveThreads;
+    int moveRegionSize;
+    n.param<int>("/wumpus_simulator/move_threads", moveThreads, 1);
+    n.param<int>("/wumpus_simulator/move_region_size", moveRegionSize, 64);
+    this->wumpusMoves.start(moveThreads, moveRegionSize);
+
+    this->ready = false;
+    bool resumed = resume && this->checkpoints.isEnabled() && resumeCheckpoint(checkpointFile);
+    if (!resumed && !startWorld.empty()) {
+        openWorld(startWorld);
+    }
+    if (!resumed && startWorld.empty() && autoReset && !this->baselineAgents.empty()) {
+        // Nobody else sends the first spawn request
+        std::lock_guard<std::mutex> lock(simulationMutex);
+        resetEpisode();
+        publishSnapshot();
+    }
     spinner = new ros::AsyncSpinner(4);
     spinner->start();
-    this->ready = false;
 }
 
-WumpusSimulator::~WumpusSimulator() {}
+WumpusSimulator::~WumpusSimulator()
+{
+    this->baselineAgents.stop();
+}
 
 void WumpusSimulator::initPlugin(qt_gui_cpp::PluginContext& context)
 {
@@ -64,10 +242,25 @@ void WumpusSimulator::initPlugin(qt_gui_cpp::PluginContext& context)
     this->connect(this->mainwindow.webView->page()->mainFrame(), SIGNAL(javaScriptWindowObjectCleared()), this, SLOT(addSimToJS()));
     this->mainwindow.webView->load(QUrl("qrc:///www/index.html"));
     this->connect(this, SIGNAL(modelChanged()), this, SLOT(callUpdatePlayground()));
-    this->ready = false;
+    // Queued, so a world created from the page is not redrawn while the page calls into the plugin
+    this->connect(this, SIGNAL(worldChanged()), this, SLOT(callRedrawWorld()), Qt::QueuedConnection);
+    // Shows a world that was opened before the page was loaded
+    this->connect(this->mainwindow.webView, SIGNAL(loadFinished(bool)), this, SLOT(callRedrawWorld()));
 }
 
-void WumpusSimulator::shutdownPlugin() {}
+void WumpusSimulator::shutdownPlugin()
+{
+    // The workers may wait for the simulation lock
+    this->baselineAgents.stop();
+    {
+        std::lock_guard<std::mutex> lock(simulationMutex);
+        this->scores.flush();
+        takeCheckpoint();
+    }
+    if (Tracer::get()->isEnabled()) {
+        Tracer::get()->flush(traceFile);
+    }
+}
 
 void WumpusSimulator::saveSettings(qt_gui_cpp::Settings& plugin_settings, qt_gui_cpp::Settings& instance_settings) const {}
 
@@ -89,11 +282,59 @@ void WumpusSimulator::createWorld(bool arrow, int wumpus, int traps, int size)
 
     std::cout << "WumpusSimulator: Creating world with: arrow: " << (arrow ? "true" : "false") << " wumpus count: " << wumpus << " trap count: " << traps
               << " field size: " << size << std::endl;
-    // Init the playground
-    this->model = Model::get();
-    this->model->init(arrow, wumpus, traps, size);
-    updatePlayground();
-    ready = true;
+    // Init the playground, optionally only with worlds in which the gold can be reached
+    bool solvable;
+    int generatorThreads;
+    n.param<bool>("/wumpus_simulator/solvable_worlds", solvable, false);
+    n.param<int>("/wumpus_simulator/generator_threads", generatorThreads, 0);
+    {
+        // Baseline agents act as soon as they are placed
+        std::lock_guard<std::mutex> lock(simulationMutex);
+        this->model = Model::get();
+        if (solvable) {
+            this->model->initSolvable(arrow, wumpus, traps, size, generatorThreads);
+        } else {
+            this->model->init(arrow, wumpus, traps, size);
+        }
+        prepareWorld();
+        placeBaselineAgents();
+        publishSnapshot();
+    }
+}
+
+QString WumpusSimulator::getKnowledge(int agentId)
+{
+    // Copied under the lock, serializing a large map must not stall the simulation
+    std::unique_ptr<KnowledgeMap> knowledge;
+    {
+        std::lock_guard<std::mutex> lock(simulationMutex);
+        auto current = this->model != nullptr ? this->model->getKnowledge(agentId) : nullptr;
+        if (current != nullptr) {
+            knowledge.reset(new KnowledgeMap(*current));
+        }
+    }
+    QJsonObject result;
+    QJsonArray visited;
+    QJsonArray perceived;
+    if (knowledge != nullptr) {
+        result["visitedCount"] = knowledge->getVisitedCount();
+        result["perceivedCount"] = knowledge->getPerceivedCount();
+        int size = knowledge->getVisited().getSize();
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                if (knowledge->isVisited(i, j)) {
+                    visited.append(QJsonArray({i, j}));
+                }
+                if (knowledge->isPerceived(i, j)) {
+                    perceived.append(QJsonArray({i, j}));
+                }
+            }
+        }
+    }
+    result["agentId"] = agentId;
+    result["visited"] = visited;
+    result["perceived"] = perceived;
+    return QString(QJsonDocument(result).toJson(QJsonDocument::Compact));
 }
 
 void WumpusSimulator::saveWorld()
@@ -119,9 +360,13 @@ void WumpusSimulator::saveWorld()
                 return;
             }
 
-            // Serialize the world as JSON
+            // Serialize the world as JSON, the snapshot lacks the agents' gold and start tiles
             if (this->model != nullptr) {
-                auto worldJson = this->model->toJSON();
+                QJsonObject worldJson;
+                {
+                    std::lock_guard<std::mutex> lock(simulationMutex);
+                    worldJson = this->model->toJSON();
+                }
 
                 // Write to file
                 QJsonDocument saveDoc(worldJson);
@@ -134,101 +379,294 @@ void WumpusSimulator::saveWorld()
 
 void WumpusSimulator::loadWorld()
 {
-    this->model = Model::get();
-    this->turns.clear();
     // Open load file dialog to select a pregenerated wumpus world
     QString filename = QFileDialog::getOpenFileName(
             this->widget_, tr("Load World"), QDir::currentPath(), tr("Wumpus World File (*.wwf)"), 0, QFileDialog::DontUseNativeDialog);
 
     // Check if the user selected a correct file
     if (!filename.isNull()) {
-        // Open file
-        QFile file(filename);
-        if (!file.open(QIODevice::ReadOnly)) {
-            qWarning("Couldn't open save file.");
-            return;
-        }
+        openWorld(filename.toStdString());
+    }
+}
 
-        QByteArray saveData = file.readAll();
-        QJsonDocument loadDoc(QJsonDocument::fromJson(saveData));
-        this->model->fromJSON(loadDoc.object());
-        this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(QString("setInitialValues(%1, %2, %3, %4);")
-                                                                                  .arg(this->model->getWumpusCount())
-                                                                                  .arg(this->model->getTrapCount())
-                                                                                  .arg(this->model->getPlayGroundSize())
-                                                                                  .arg(this->model->getAgentHasArrow()));
-        this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(QString("drawPlayground();"));
-        updatePlayground();
-        ready = true;
+bool WumpusSimulator::openWorld(const std::string& world)
+{
+    auto record = this->worlds.get(world);
+    if (record == nullptr) {
+        std::cout << "WumpusSimulator: unknown world " << world << std::endl;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(simulationMutex);
+        this->model = Model::get();
+        this->model->fromRecord(*record);
+        prepareWorld();
+        placeBaselineAgents();
+        publishSnapshot();
     }
+    std::cout << "WumpusSimulator: opened world " << record->id << std::endl;
+    return true;
 }
 
-void WumpusSimulator::updatePlayground()
+bool WumpusSimulator::onLoadWorld(LoadWorld::Request& req, LoadWorld::Response& res)
 {
-    QString clear = QString("clearTiles();");
-    auto playGround = this->model->getPlayGround();
-    this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(clear);
-    for (int i = 0; i < this->model->getPlayGroundSize(); i++) {
-        for (int j = 0; j < this->model->getPlayGroundSize(); j++) {
-            QString f = QString("addDirtImage(%1,%2);").arg(i).arg(j);
-            this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(f);
-            if (playGround.at(i).at(j)->getStench()) {
-                QString func = QString("addStenchImage(%1,%2);").arg(i).arg(j);
-                this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
-            }
-            if (playGround.at(i).at(j)->getBreeze()) {
-                QString func = QString("addBreezeImage(%1,%2);").arg(i).arg(j);
-                this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
-            }
+    res.success = openWorld(req.world);
+    if (res.success) {
+        auto snapshot = getSnapshot();
+        res.playGroundSize = snapshot->playGroundSize;
+        res.wumpusCount = snapshot->wumpusCount;
+        res.trapCount = snapshot->trapCount;
+        res.seed = snapshot->seed;
+    }
+    return true;
+}
 
-            if (playGround.at(i).at(j)->getTrap()) {
-                QString func = QString("addTrapImage(%1,%2);").arg(i).arg(j);
-                this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
-            }
-            if (playGround.at(i).at(j)->getGold()) {
-                QString func = QString("addGoldImage(%1,%2);").arg(i).arg(j);
-                this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
+bool WumpusSimulator::resumeCheckpoint(const std::string& path)
+{
+    WorldRecord world;
+    std::vector<int> order;
+    int index;
+    if (!Checkpointer::read(path, world, order, index)) {
+        std::cout << "WumpusSimulator: no checkpoint in " << path << std::endl;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(simulationMutex);
+        this->model = Model::get();
+        this->model->fromRecord(world);
+        prepareWorld();
+        for (int id : order) {
+            if (id > 0) {
+                this->scores.spawn(id);
             }
-            if (playGround.at(i).at(j)->getStartpoint()) {
-                QString func = QString("addEntryPoint(%1,%2);").arg(i).arg(j);
-                this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
+            if (std::find(this->registered.begin(), this->registered.end(), id) == this->registered.end()) {
+                this->registered.push_back(id);
             }
-            if (playGround.at(i).at(j)->hasMovable()) {
-                if (playGround.at(i).at(j)->getMovable()->getType().contains("wumpus")) {
+        }
+        this->turns = order;
+        this->turnIndex = order.empty() ? 0 : std::max(index, 0) % order.size();
+        // Possessed wumpus are part of the checkpoint
+        selectRules();
+        if (!this->turns.empty()) {
+            announceTurn();
+        }
+        publishSnapshot();
+    }
+    std::cout << "WumpusSimulator: resumed " << path << " at turn " << this->turnIndex << " of " << order.size() << std::endl;
+    return true;
+}
+
+void WumpusSimulator::takeCheckpoint()
+{
+    if (!this->ready || !this->checkpoints.isEnabled()) {
+        return;
+    }
+    WUMPUS_TRACE("takeCheckpoint");
+    collectChanges();
+    this->checkpoints.submit(this->turns, this->turnIndex);
+}
+
+void WumpusSimulator::onCheckpointTimer(const ros::WallTimerEvent& event)
+{
+    std::lock_guard<std::mutex> lock(simulationMutex);
+    takeCheckpoint();
+}
+
+void WumpusSimulator::collectChanges()
+{
+    if (!this->ready) {
+        return;
+    }
+    WorldRecord changes;
+    uint32_t resetCount = this->model->takeChanges(changes);
+    if (this->worldStream.isEnabled()) {
+        publishDelta(resetCount, changes);
+    }
+    if (this->checkpoints.isEnabled()) {
+        this->checkpoints.add(resetCount, std::move(changes));
+    }
+}
+
+void WumpusSimulator::publishDelta(uint32_t resetCount, const WorldRecord& changes)
+{
+    WUMPUS_TRACE("publishDelta");
+    if (this->deltaPub.getNumSubscribers() == 0) {
+        // The changes are lost, the next viewer starts with a keyframe
+        this->worldStream.requestKeyframe();
+        return;
+    }
+    WorldDelta msg;
+    if (this->worldStream.needsKeyframe(resetCount)) {
+        WorldRecord world;
+        this->model->toRecord(world);
+        this->worldStream.encode(resetCount, world, true, msg);
+    } else {
+        this->worldStream.encode(resetCount, changes, false, msg);
+    }
+    this->deltaPub.publish(msg);
+}
+
+void WumpusSimulator::onDeltaTimer(const ros::WallTimerEvent& event)
+{
+    std::lock_guard<std::mutex> lock(simulationMutex);
+    collectChanges();
+}
+
+void WumpusSimulator::prepareWorld()
+{
+    this->turns.clear();
+    this->turnIndex = 0;
+    this->turnDeadlineArmed = false;
+    this->consecutiveTimeouts.clear();
+    this->penaltyTurns.clear();
+    // Spawn positions are reproducible for the same world and order of spawns
+    this->spawnRandom.seed(this->model->getSeed());
+    assignWumpusBehaviour();
+    selectRules();
+    updateLiveGauges();
+    beginEpisode();
+    this->ready = true;
+}
+
+void WumpusSimulator::redrawWorld()
+{
+    auto snapshot = getSnapshot();
+    this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(QString("setInitialValues(%1, %2, %3, %4);")
+                                                                              .arg(snapshot->wumpusCount)
+                                                                              .arg(snapshot->trapCount)
+                                                                              .arg(snapshot->playGroundSize)
+                                                                              .arg(snapshot->agentHasArrow));
+    // Draws the grid of the visible tiles, the web view reports the viewport back with setViewport
+    this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(QString("drawPlayground();"));
+}
+
+void WumpusSimulator::setViewport(int row, int col, int rows, int cols, int block)
+{
+    this->viewRow = std::max(row, 0);
+    this->viewCol = std::max(col, 0);
+    this->viewRows = std::max(rows, 0);
+    this->viewCols = std::max(cols, 0);
+    this->overviewBlock = std::max(block, 0);
+    updatePlayground();
+}
+
+std::shared_ptr<const RenderSnapshot> WumpusSimulator::getSnapshot()
+{
+    return std::atomic_load(&this->snapshot);
+}
+
+void WumpusSimulator::publishSnapshot()
+{
+    auto previous = std::atomic_load(&this->snapshot);
+    auto next = this->model->takeSnapshot(previous);
+    std::atomic_store(&this->snapshot, next);
+    // Emitted after the store, so the slots on the Qt thread never draw an older snapshot
+    if (previous == nullptr || previous->resetCount != next->resetCount) {
+        emit worldChanged();
+    } else {
+        emit modelChanged();
+    }
+}
+
+void WumpusSimulator::updatePlayground()
+{
+    WUMPUS_TRACE("updatePlayground");
+    // The snapshot is immutable, drawing never waits for the simulation
+    auto snapshot = getSnapshot();
+    if (snapshot == nullptr) {
+        return;
+    }
+    auto renderStart = std::chrono::steady_clock::now();
+    // Only the visible tiles are sent, off-screen tiles are not part of the page
+    int size = snapshot->playGroundSize;
+    int firstRow = std::min(this->viewRow, std::max(size - 1, 0));
+    int firstCol = std::min(this->viewCol, std::max(size - 1, 0));
+    int lastRow = std::min(size, firstRow + (this->viewRows > 0 ? this->viewRows : DEFAULT_VIEW_SIZE));
+    int lastCol = std::min(size, firstCol + (this->viewCols > 0 ? this->viewCols : DEFAULT_VIEW_SIZE));
+    if (this->overviewBlock > 0) {
+        updateOverview(*snapshot, firstRow, firstCol, lastRow - firstRow, lastCol - firstCol);
+    } else {
+        QString script = QString("clearTiles();");
+        for (int i = firstRow; i < lastRow; i++) {
+            for (int j = firstCol; j < lastCol; j++) {
+                auto cell = snapshot->getCell(i, j);
+                QString f = QString("addDirtImage(%1,%2);").arg(i).arg(j);
+                script += f;
+                if (cell.state & RenderSnapshot::stench) {
+                    QString func = QString("addStenchImage(%1,%2);").arg(i).arg(j);
+                    script += func;
+                }
+                if (cell.state & RenderSnapshot::breeze) {
+                    QString func = QString("addBreezeImage(%1,%2);").arg(i).arg(j);
+                    script += func;
+                }
+
+                if (cell.state & RenderSnapshot::trap) {
+                    QString func = QString("addTrapImage(%1,%2);").arg(i).arg(j);
+                    script += func;
+                }
+                if (cell.state & RenderSnapshot::gold) {
+                    QString func = QString("addGoldImage(%1,%2);").arg(i).arg(j);
+                    script += func;
+                }
+                if (cell.state & RenderSnapshot::startpoint) {
+                    QString func = QString("addEntryPoint(%1,%2);").arg(i).arg(j);
+                    script += func;
+                }
+                if (cell.state & RenderSnapshot::wumpus) {
                     QString func = QString("addWumpusImage(%1,%2);").arg(i).arg(j);
-                    this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
+                    script += func;
                 }
-                if (playGround.at(i).at(j)->getMovable()->getType().contains("agent")) {
-                    auto tmp = std::dynamic_pointer_cast<Agent>(playGround.at(i).at(j)->getMovable());
-                    if (tmp == nullptr) {
-                        continue;
-                    }
+                if (cell.state & RenderSnapshot::agent) {
+                    int id = cell.agentId;
 
-                    if (playGround.at(i).at(j)->getMovable()->getId() % 2 == 0) {
-                        QString func = QString("addAgent(%1,%2,%3,%4,%5);")
-                                               .arg(i)
-                                               .arg(j)
-                                               .arg(playGround.at(i).at(j)->getMovable()->getId())
-                                               .arg("\"female\"")
-                                               .arg(tmp->getHeading());
-                        this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
+                    if (id % 2 == 0) {
+                        QString func = QString("addAgent(%1,%2,%3,%4,%5);").arg(i).arg(j).arg(id).arg("\"female\"").arg(cell.heading);
+                        script += func;
                     } else {
-                        QString func = QString("addAgent(%1,%2,%3,%4,%5);")
-                                               .arg(i)
-                                               .arg(j)
-                                               .arg(playGround.at(i).at(j)->getMovable()->getId())
-                                               .arg("\"male\"")
-                                               .arg(tmp->getHeading());
-                        this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(func);
+                        QString func = QString("addAgent(%1,%2,%3,%4,%5);").arg(i).arg(j).arg(id).arg("\"male\"").arg(cell.heading);
+                        script += func;
                     }
                 }
             }
         }
+        // One call into the page instead of one per image
+        this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(script);
+    }
+    auto renderMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - renderStart).count();
+    Metrics::get()->increment(Metrics::renders);
+    Metrics::get()->increment(Metrics::renderMicros, renderMicros);
+    Metrics::get()->set(Metrics::lastRenderMicros, renderMicros);
+}
+
+void WumpusSimulator::updateOverview(const RenderSnapshot& snapshot, int row, int col, int rows, int cols)
+{
+    auto overview = snapshot.getOverview(row, col, rows, cols, this->overviewBlock);
+    QString hazards;
+    QString gold;
+    QString agents;
+    for (size_t i = 0; i < overview.hazards.size(); i++) {
+        QString separator = i > 0 ? "," : "";
+        hazards += separator + QString::number(overview.hazards[i]);
+        gold += separator + QString::number(overview.gold[i]);
+        agents += separator + QString::number(overview.agents[i]);
     }
+    this->mainwindow.webView->page()->mainFrame()->evaluateJavaScript(QString("drawOverview(%1,%2,%3,[%4],[%5],[%6]);")
+                                                                              .arg(overview.block)
+                                                                              .arg(overview.rows)
+                                                                              .arg(overview.cols)
+                                                                              .arg(hazards)
+                                                                              .arg(gold)
+                                                                              .arg(agents));
 }
 
 void WumpusSimulator::onSpawnAgent(InitialPoseRequestPtr msg)
 {
+    std::lock_guard<std::mutex> lock(simulationMutex);
+    if (!ready && autoReset) {
+        // Unattended runs start with the first spawn request
+        resetEpisode();
+    }
     if (!ready) {
         return;
     }
@@ -238,7 +676,54 @@ void WumpusSimulator::onSpawnAgent(InitialPoseRequestPtr msg)
         possessWumpus(msg->agentId);
     } else {
         std::cout << "WumpusSimulator: ID = 0 not supported!" << std::endl;
+        return;
+    }
+    if (std::find(this->registered.begin(), this->registered.end(), msg->agentId) == this->registered.end()) {
+        this->registered.push_back(msg->agentId);
     }
+    publishSnapshot();
+}
+
+void WumpusSimulator::onSpawnAgents(SpawnAgentsRequestPtr msg)
+{
+    std::lock_guard<std::mutex> lock(simulationMutex);
+    if (!ready && autoReset) {
+        resetEpisode();
+    }
+    if (!ready) {
+        return;
+    }
+    bool idle = this->turns.empty();
+    std::unordered_set<int> known(this->registered.begin(), this->registered.end());
+    SpawnAgentsResponse response;
+    response.poses.reserve(msg->agentIds.size());
+    for (int id : msg->agentIds) {
+        if (id > 0) {
+            InitialPoseResponse pose;
+            if (!spawnAgent(id, this->model->getAgentHasArrow(), pose)) {
+                continue;
+            }
+            if (this->baselineAgents.contains(id)) {
+                this->baselineAgents.spawn(pose);
+            } else {
+                response.poses.push_back(pose);
+            }
+        } else if (id < 0) {
+            possessWumpus(id);
+        } else {
+            std::cout << "WumpusSimulator: ID = 0 not supported!" << std::endl;
+            continue;
+        }
+        if (known.insert(id).second) {
+            this->registered.push_back(id);
+        }
+    }
+    // All poses in one message, the first turn only after the agents know where they are
+    this->spawnAgentsPub.publish(response);
+    if (idle && !this->turns.empty()) {
+        announceTurn();
+    }
+    publishSnapshot();
 }
 
 void WumpusSimulator::callUpdatePlayground()
@@ -246,8 +731,19 @@ void WumpusSimulator::callUpdatePlayground()
     updatePlayground();
 }
 
+void WumpusSimulator::callRedrawWorld()
+{
+    if (getSnapshot() != nullptr) {
+        redrawWorld();
+    }
+}
+
 void WumpusSimulator::onAction(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("onAction");
+    Metrics::get()->add(Metrics::pendingActions, 1);
+    std::lock_guard<std::mutex> lock(simulationMutex);
+    Metrics::get()->add(Metrics::pendingActions, -1);
     if (!ready) {
         return;
     }
@@ -256,247 +752,240 @@ void WumpusSimulator::onAction(ActionRequestPtr msg)
     }
     if (msg->agentId != this->turns.at(this->turnIndex)) {
         std::cout << "WumpusSimulator: agent is not allowed to move! It's agent's " << this->turns.at(this->turnIndex) << " turn!" << std::endl;
+        Metrics::get()->increment(Metrics::rejectedActions);
         return;
     }
-    bool found = false;
-    for (auto mov : this->model->movables) {
-        if (msg->agentId == mov->getId()) {
-            found = true;
-            break;
-        }
-    }
+    bool found = msg->agentId > 0 ? this->model->getAgentByID(msg->agentId).isValid() : this->model->getWumpusByID(msg->agentId).isValid();
     if (found) {
+        this->consecutiveTimeouts[msg->agentId] = 0;
+        Metrics::get()->increment(Metrics::actions);
         if (msg->agentId > 0) {
+            this->scores.turn(msg->agentId);
             handleAction(msg);
         } else {
             handleWumpusAction(msg);
         }
+        checkEpisodeEnd();
+        publishSnapshot();
     }
 }
 
 void WumpusSimulator::possessWumpus(int wumpusId)
 {
-    for (int i = 0; i < model->movables.size(); i++) {
-        if (this->model->movables.at(i)->getId() == wumpusId) {
-            std::cout << "WumpusSimulator: Wumpus with this id already possessed!" << std::endl;
-            return;
-        }
-    }
-    bool available = false;
-    for (auto mov : this->model->movables) {
-        if (mov->getId() == 0) {
-            mov->setId(wumpusId);
-            turns.push_back(wumpusId);
-            available = true;
-            break;
-        }
+    auto& entities = this->model->entities;
+    if (entities.find(wumpusId, EntityRegistry::wumpus).isValid()) {
+        std::cout << "WumpusSimulator: Wumpus with this id already possessed!" << std::endl;
+        return;
     }
-    if (!available) {
+    auto wumpus = entities.find(0, EntityRegistry::wumpus);
+    if (!wumpus.isValid()) {
         std::cout << "WumpusSimulator: no Wumpus available!" << std::endl;
+        return;
     }
+    entities.setId(wumpus, wumpusId);
+    entities.setBehaviour(wumpus, nullptr);
+    turns.push_back(wumpusId);
+    // The wumpus might have been the last one that moved on its own
+    selectRules();
 }
 
 void WumpusSimulator::placeAgent(int agentId, bool hasArrow)
 {
-    for (int i = 0; i < model->movables.size(); i++) {
-        if (this->model->movables.at(i)->getId() == agentId) {
-            std::cout << "WumpusSimulator: Agent with this id already placed!" << std::endl;
-            return;
-        }
-    }
-    /* initialize random seed: */
-    srand(time(NULL));
-    bool placed = false;
+    WUMPUS_TRACE("placeAgent");
     InitialPoseResponse msg;
-    int attempts = 0;
-    while (!placed) {
-        if (attempts > (pow(model->getPlayGroundSize(), 3))) {
-            std::cout << "Abort! Cannot find empty tile to place agent on." << std::endl;
-            break;
-        }
-        int randx = rand() % (this->model->getPlayGroundSize() - 1);
-        int randy = rand() % (this->model->getPlayGroundSize() - 1);
-
-        auto tile = this->model->getPlayGround().at(randx).at(randy);
-        if (!tile->getTrap() && !tile->hasMovable() && !tile->getGold() && !tile->getBreeze() && !tile->getStench() && !tile->getStartpoint()) {
-            auto agent = std::make_shared<Agent>(this->model->getPlayGround().at(randx).at(randy));
-            agent->setId(agentId);
-            agent->setArrow(hasArrow);
-            agent->setHeading(WumpusEnums::heading::up);
-            this->model->getPlayGround().at(randx).at(randy)->setMovable(agent);
-            this->model->movables.push_back(agent);
-            tile->setStartAgentID(agentId);
-            tile->setStartpoint(true);
-            placed = true;
-            msg.x = randx;
-            msg.y = randy;
-            msg.agentId = agentId;
-            msg.fieldSize = this->model->getPlayGroundSize();
-            msg.hasArrow = hasArrow;
-            msg.heading = agent->getHeading();
-            this->spawnAgentPub.publish(msg);
-            turns.push_back(agent->getId());
-            if (turns.size() == 1) {
-                ActionResponse msg2;
-                msg2.x = agent->getTile()->getX();
-                msg2.y = agent->getTile()->getY();
-                msg2.agentId = agent->getId();
-                msg2.heading = agent->getHeading();
-                msg2.responses.push_back(WumpusEnums::responses::yourTurn);
-                handlePerception(msg2, agent->getTile());
-                this->actionPub.publish(msg2);
-            }
-        }
-        attempts++;
+    if (!spawnAgent(agentId, hasArrow, msg)) {
+        return;
+    }
+    if (this->baselineAgents.contains(agentId)) {
+        this->baselineAgents.spawn(msg);
+    } else {
+        this->spawnAgentPub.publish(msg);
+    }
+    if (turns.size() == 1) {
+        announceTurn();
+    }
+}
+
+bool WumpusSimulator::spawnAgent(int agentId, bool hasArrow, InitialPoseResponse& msg)
+{
+    if (this->model->getAgentByID(agentId).isValid()) {
+        std::cout << "WumpusSimulator: Agent with this id already placed!" << std::endl;
+        return false;
     }
-    emit modelChanged();
+    int x;
+    int y;
+    if (!this->model->pickSpawnTile(this->spawnRandom, x, y)) {
+        std::cout << "Abort! Cannot find empty tile to place agent on." << std::endl;
+        return false;
+    }
+    auto tile = this->model->getTile(x, y);
+    auto agent = this->model->entities.create(EntityRegistry::agent, agentId, x, y);
+    this->model->entities.setArrow(agent, hasArrow);
+    this->model->entities.setHeading(agent, WumpusEnums::heading::up);
+    tile->setEntity(agent, EntityRegistry::agent);
+    tile->setStartAgentID(agentId);
+    tile->setStartpoint(true);
+    this->model->visit(agentId, x, y);
+    msg.x = x;
+    msg.y = y;
+    msg.agentId = agentId;
+    msg.fieldSize = this->model->getPlayGroundSize();
+    msg.hasArrow = hasArrow;
+    msg.heading = WumpusEnums::heading::up;
+    turns.push_back(agentId);
+    Metrics::get()->increment(Metrics::spawns);
+    Metrics::get()->add(Metrics::liveAgents, 1);
+    this->scores.spawn(agentId);
+    this->consecutiveTimeouts.erase(agentId);
+    this->penaltyTurns.erase(agentId);
+    return true;
 }
 
 void WumpusSimulator::handleTurnRight(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("handleTurnRight");
     ActionResponse response;
+    auto& entities = this->model->entities;
     auto agent = this->model->getAgentByID(msg->agentId);
-    auto tmp = (((agent->getHeading() - 1) + 4) % 4);
-    agent->setHeading((WumpusEnums::heading)(tmp));
-    response.agentId = agent->getId();
-    response.x = agent->getTile()->getX();
-    response.y = agent->getTile()->getY();
+    auto tmp = (((entities.getHeading(agent) - 1) + 4) % 4);
+    entities.setHeading(agent, (WumpusEnums::heading)(tmp));
+    this->scores.rotate(msg->agentId);
+    response.agentId = msg->agentId;
+    response.x = entities.getX(agent);
+    response.y = entities.getY(agent);
     response.heading = tmp;
-    this->actionPub.publish(response);
-    emit modelChanged();
+    publishAction(response);
 }
 
 void WumpusSimulator::handleTurnLeft(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("handleTurnLeft");
     ActionResponse response;
+    auto& entities = this->model->entities;
     auto agent = this->model->getAgentByID(msg->agentId);
-    auto tmp = ((agent->getHeading() + 1) % 4);
-    agent->setHeading((WumpusEnums::heading)(tmp));
-    response.agentId = agent->getId();
-    response.x = agent->getTile()->getX();
-    response.y = agent->getTile()->getY();
+    auto tmp = ((entities.getHeading(agent) + 1) % 4);
+    entities.setHeading(agent, (WumpusEnums::heading)(tmp));
+    this->scores.rotate(msg->agentId);
+    response.agentId = msg->agentId;
+    response.x = entities.getX(agent);
+    response.y = entities.getY(agent);
     response.heading = tmp;
-    this->actionPub.publish(response);
-    emit modelChanged();
+    publishAction(response);
 }
 
+template <class Rules>
 void WumpusSimulator::handleShoot(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("handleShoot");
     ActionResponse response;
+    auto& entities = this->model->entities;
     auto agent = this->model->getAgentByID(msg->agentId);
-    response.agentId = agent->getId();
-    response.x = agent->getTile()->getX();
-    response.y = agent->getTile()->getY();
-    response.heading = agent->getHeading();
-    if (agent->hasArrow()) {
-        if (agent->getHeading() == WumpusEnums::heading::left) {
-            handleShootLeft(response, agent);
-        } else if (agent->getHeading() == WumpusEnums::heading::right) {
-            handleShootRight(response, agent);
-        } else if (agent->getHeading() == WumpusEnums::heading::up) {
-            handleShootUp(response, agent);
-        } else {
-            handleShootDown(response, agent);
-        }
-        agent->setArrow(false);
-        handlePerception(response, agent->getTile());
+    response.agentId = msg->agentId;
+    response.x = entities.getX(agent);
+    response.y = entities.getY(agent);
+    response.heading = entities.getHeading(agent);
+    if (Rules::ARROW && entities.hasArrow(agent)) {
+        this->scores.shot(msg->agentId);
+        shootArrow(response, agent);
+        entities.setArrow(agent, false);
+        handlePerception(response, this->model->peekTile(agent));
     } else {
         response.responses.push_back(WumpusEnums::responses::notAllowed);
-        handlePerception(response, agent->getTile());
+        handlePerception(response, this->model->peekTile(agent));
     }
-    this->actionPub.publish(response);
-    emit modelChanged();
+    publishAction(response);
 }
 
 void WumpusSimulator::handlePickUpGold(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("handlePickUpGold");
     ActionResponse response;
+    auto& entities = this->model->entities;
     auto agent = this->model->getAgentByID(msg->agentId);
-    response.agentId = agent->getId();
-    response.x = agent->getTile()->getX();
-    response.y = agent->getTile()->getY();
-    response.heading = agent->getHeading();
-    if (agent->getTile()->getGold()) {
+    auto tile = this->model->peekTile(agent);
+    response.agentId = msg->agentId;
+    response.x = entities.getX(agent);
+    response.y = entities.getY(agent);
+    response.heading = entities.getHeading(agent);
+    if (tile->getGold()) {
         response.responses.push_back(WumpusEnums::responses::goldFound);
-        agent->setHasGold(true);
+        entities.setHasGold(agent, true);
+        this->scores.gold(msg->agentId);
     } else {
         response.responses.push_back(WumpusEnums::responses::notAllowed);
     }
-    handlePerception(response, agent->getTile());
-    this->actionPub.publish(response);
-    emit modelChanged();
+    handlePerception(response, tile);
+    publishAction(response);
 }
 
 void WumpusSimulator::handleExit(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("handleExit");
     ActionResponse response;
+    auto& entities = this->model->entities;
     auto agent = this->model->getAgentByID(msg->agentId);
-    response.agentId = agent->getId();
-    response.x = agent->getTile()->getX();
-    response.y = agent->getTile()->getY();
-    response.heading = agent->getHeading();
-    if (agent->getHasGold() && agent->getTile()->getStartAgentID() == agent->getId()) {
+    response.agentId = msg->agentId;
+    response.x = entities.getX(agent);
+    response.y = entities.getY(agent);
+    response.heading = entities.getHeading(agent);
+    if (entities.hasGold(agent) && this->model->peekTile(agent)->getStartAgentID() == msg->agentId) {
         response.responses.push_back(WumpusEnums::responses::exited);
-        this->turns.erase(std::find(this->turns.begin(), this->turns.end(), agent->getId()));
+        removeFromTurns(msg->agentId);
         this->model->exit(agent);
+        Metrics::get()->increment(Metrics::exits);
+        Metrics::get()->add(Metrics::liveAgents, -1);
+        this->scores.finish(msg->agentId, ScoreBoard::exited);
     } else {
         response.responses.push_back(WumpusEnums::responses::notAllowed);
     }
-    this->actionPub.publish(response);
-    emit modelChanged();
+    publishAction(response);
 }
 
 void WumpusSimulator::handleMove(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("handleMove");
     ActionResponse response;
+    auto& entities = this->model->entities;
     auto agent = this->model->getAgentByID(msg->agentId);
-    response.agentId = agent->getId();
-    int x = agent->getTile()->getX();
-    int y = agent->getTile()->getY();
-    if ((x == 0 && agent->getHeading() == WumpusEnums::heading::up) ||
-            (x == this->model->getPlayGroundSize() - 1 && agent->getHeading() == WumpusEnums::heading::down) ||
-            (y == 0 && agent->getHeading() == WumpusEnums::heading::left) ||
-            (y == this->model->getPlayGroundSize() - 1 && agent->getHeading() == WumpusEnums::heading::right)) {
+    auto heading = entities.getHeading(agent);
+    response.agentId = msg->agentId;
+    response.heading = heading;
+    int x = entities.getX(agent);
+    int y = entities.getY(agent);
+    if ((x == 0 && heading == WumpusEnums::heading::up) || (x == this->model->getPlayGroundSize() - 1 && heading == WumpusEnums::heading::down) ||
+            (y == 0 && heading == WumpusEnums::heading::left) || (y == this->model->getPlayGroundSize() - 1 && heading == WumpusEnums::heading::right)) {
         response.x = x;
         response.y = y;
-        response.heading = agent->getHeading();
         response.responses.push_back(WumpusEnums::responses::bump);
+        this->scores.bump(msg->agentId);
     } else {
-        if (agent->getHeading() == WumpusEnums::heading::up) {
-            x -= 1;
-        } else if (agent->getHeading() == WumpusEnums::heading::down) {
-            x += 1;
-        } else if (agent->getHeading() == WumpusEnums::heading::left) {
-            y -= 1;
-        } else {
-            y += 1;
-        }
+        x += WumpusEnums::stepX(heading);
+        y += WumpusEnums::stepY(heading);
 
         response.x = x;
         response.y = y;
-        response.heading = agent->getHeading();
 
-        if (this->model->getTile(x, y)->getTrap() || this->model->getTile(x, y)->hasWumpus()) {
-            this->killAgent(agent);
-        } else if (this->model->getTile(x, y)->hasMovable() && !this->model->getTile(x, y)->hasWumpus()) {
-            response.x = agent->getTile()->getX();
-            response.y = agent->getTile()->getY();
+        auto target = this->model->peekTile(x, y);
+        if (target->getTrap() || target->hasWumpus()) {
+            this->killAgent(agent, target->getTrap() ? ScoreBoard::trap : ScoreBoard::eaten);
+        } else if (target->hasAgent()) {
+            response.x = entities.getX(agent);
+            response.y = entities.getY(agent);
             response.responses.push_back(WumpusEnums::responses::otherAgent);
         } else {
-            this->model->removeAgent(agent);
-            agent->setTile(this->model->getTile(x, y));
-            agent->getTile()->setMovable(agent);
+            this->model->moveEntity(agent, x, y);
+            this->model->visit(msg->agentId, x, y);
+            this->scores.step(msg->agentId);
         }
     }
-    auto tmp = this->model->getTile(x, y);
-    handlePerception(response, tmp);
+    handlePerception(response, this->model->peekTile(x, y));
 
-    this->actionPub.publish(response);
-    emit modelChanged();
+    publishAction(response);
 }
 
 void WumpusSimulator::handleWumpusAction(ActionRequestPtr msg)
 {
+    WUMPUS_TRACE("handleWumpusAction");
     if (!(msg->action == WumpusEnums::heading::up || msg->action == WumpusEnums::heading::down || msg->action == WumpusEnums::heading::left ||
                 msg->action == WumpusEnums::heading::right)) {
 
@@ -506,58 +995,107 @@ void WumpusSimulator::handleWumpusAction(ActionRequestPtr msg)
 
     ActionResponse response;
     auto wumpus = this->model->getWumpusByID(msg->agentId);
-    response.agentId = wumpus->getId();
-    int x = wumpus->getTile()->getX();
-    int y = wumpus->getTile()->getY();
-    if ((x == 0 && msg->action == WumpusEnums::heading::up) || (x == this->model->getPlayGroundSize() - 1 && msg->action == WumpusEnums::heading::down) ||
-            (y == 0 && msg->action == WumpusEnums::heading::left) ||
-            (y == this->model->getPlayGroundSize() - 1 && msg->action == WumpusEnums::heading::right)) {
+    moveWumpus(wumpus, msg->action, response);
+    updateStench();
+    publishAction(response);
+    handleNextTurn();
+}
+
+void WumpusSimulator::moveWumpus(EntityHandle wumpus, int direction, ActionResponse& response)
+{
+    auto& entities = this->model->entities;
+    response.agentId = entities.getId(wumpus);
+    int x = entities.getX(wumpus);
+    int y = entities.getY(wumpus);
+    if ((x == 0 && direction == WumpusEnums::heading::up) || (x == this->model->getPlayGroundSize() - 1 && direction == WumpusEnums::heading::down) ||
+            (y == 0 && direction == WumpusEnums::heading::left) || (y == this->model->getPlayGroundSize() - 1 && direction == WumpusEnums::heading::right)) {
         response.x = x;
         response.y = y;
         response.heading = WumpusEnums::heading::down;
         response.responses.push_back(WumpusEnums::responses::bump);
-    } else {
-        if (msg->action == WumpusEnums::heading::up) {
-            x -= 1;
-        } else if (msg->action == WumpusEnums::heading::down) {
-            x += 1;
-        } else if (msg->action == WumpusEnums::heading::left) {
-            y -= 1;
-        } else {
-            y += 1;
-        }
+        return;
+    }
+    x += WumpusEnums::stepX(direction);
+    y += WumpusEnums::stepY(direction);
+
+    response.x = x;
+    response.y = y;
+    response.heading = WumpusEnums::heading::down;
+
+    auto target = this->model->peekTile(x, y);
+    if (target->hasWumpus()) {
+        // Wumpus cannot share a tile
+        response.x = entities.getX(wumpus);
+        response.y = entities.getY(wumpus);
+        response.responses.push_back(WumpusEnums::responses::otherAgent);
+        return;
+    }
 
-        response.x = x;
-        response.y = y;
-        response.heading = WumpusEnums::heading::down;
+    if (target->hasAgent()) {
+        this->killAgent(target->getEntity(), ScoreBoard::eaten);
+        response.responses.push_back(WumpusEnums::responses::killedAgent);
+    }
 
-        if (this->model->getTile(x, y)->hasWumpus()) {
-            response.x = wumpus->getTile()->getX();
-            response.y = wumpus->getTile()->getY();
-            response.responses.push_back(WumpusEnums::responses::otherAgent);
-        }
+    this->model->removeWumpus(wumpus);
+    this->model->moveEntity(wumpus, x, y);
+}
 
-        if (this->model->getTile(x, y)->hasMovable() && !this->model->getTile(x, y)->hasWumpus()) {
-            auto tmp = std::dynamic_pointer_cast<Agent>(this->model->getTile(x, y)->getMovable());
-            this->killAgent(tmp);
-            response.responses.push_back(WumpusEnums::responses::killedAgent);
+void WumpusSimulator::updateStench()
+{
+    auto& entities = this->model->entities;
+    entities.forEach([&](EntityHandle entity) {
+        if (entities.getKind(entity) == EntityRegistry::wumpus) {
+            this->model->setStench(entities.getX(entity), entities.getY(entity));
         }
+    });
+}
 
-        this->model->removeWumpus(wumpus);
-        wumpus->setTile(this->model->getTile(x, y));
-        wumpus->getTile()->setMovable(wumpus);
-        for (auto mov : this->model->movables) {
-            if (mov->getId() <= 0) {
-                this->model->setStench(mov->getTile()->getX(), mov->getTile()->getY());
-            }
+void WumpusSimulator::handleAutonomousWumpus()
+{
+    WUMPUS_TRACE("handleAutonomousWumpus");
+    auto& entities = this->model->entities;
+    // Collect first, killed agents are destroyed while moving
+    std::vector<EntityHandle> autonomous;
+    entities.forEach([&](EntityHandle entity) {
+        if (entities.getKind(entity) == EntityRegistry::wumpus && entities.getId(entity) == 0 && entities.getBehaviour(entity) != nullptr) {
+            autonomous.push_back(entity);
         }
+    });
+    if (autonomous.empty()) {
+        return;
     }
-    this->actionPub.publish(response);
-    handleNextTurn();
-    emit modelChanged();
+    // Applied in the original order, so kills, scores and messages do not depend on the thread count
+    for (auto& intent : this->wumpusMoves.resolve(this->model, autonomous)) {
+        if (!intent.moves) {
+            continue;
+        }
+        // Nobody listens to unpossessed wumpus, the response is not published
+        ActionResponse response;
+        moveWumpus(intent.wumpus, intent.direction, response);
+    }
+    updateStench();
+}
+
+void WumpusSimulator::assignWumpusBehaviour()
+{
+    std::string name;
+    n.param<std::string>("/wumpus_simulator/wumpus_behaviour", name, "static");
+    unsigned int seed = this->model->getSeed();
+    auto& entities = this->model->entities;
+    entities.forEach([&](EntityHandle entity) {
+        if (entities.getKind(entity) == EntityRegistry::wumpus && entities.getId(entity) == 0) {
+            entities.setBehaviour(entity, WumpusBehaviour::create(name, seed++));
+        }
+    });
 }
 
 void WumpusSimulator::handleAction(ActionRequestPtr msg)
+{
+    (this->*actionHandler)(msg);
+}
+
+template <class Rules>
+void WumpusSimulator::applyAction(ActionRequestPtr msg)
 {
 
     switch (msg->action) {
@@ -574,7 +1112,7 @@ void WumpusSimulator::handleAction(ActionRequestPtr msg)
         break;
     }
     case WumpusEnums::actions::shoot: {
-        handleShoot(msg);
+        handleShoot<Rules>(msg);
         break;
     }
     case WumpusEnums::actions::turnLeft: {
@@ -590,160 +1128,305 @@ void WumpusSimulator::handleAction(ActionRequestPtr msg)
         std::cout << "WumpusSimulator: unknown Action received" << std::endl;
         break;
     }
-    handleNextTurn();
+    applyNextTurn<Rules>();
 }
 
 void WumpusSimulator::handleNextTurn()
 {
+    (this->*nextTurnHandler)();
+}
+
+template <class Rules>
+void WumpusSimulator::applyNextTurn()
+{
+    WUMPUS_TRACE("handleNextTurn");
     if (this->turns.size() == 0) {
         return;
     }
-    getNext();
+    advanceTurn<Rules>();
+    // Skip agents that still have to sit out turns because they timed out
+    for (size_t skipped = 0; skipped < this->turns.size() && this->penaltyTurns[this->turns.at(turnIndex)] > 0; skipped++) {
+        this->penaltyTurns[this->turns.at(turnIndex)]--;
+        advanceTurn<Rules>();
+    }
+    if (this->turns.size() == 0) {
+        return;
+    }
+    announceTurn();
+}
+
+void WumpusSimulator::announceTurn()
+{
     ActionResponse response;
     auto id = this->turns.at(turnIndex);
     response.agentId = id;
+    auto& entities = this->model->entities;
     if (id > 0) {
         auto agent = this->model->getAgentByID(id);
-        response.heading = agent->getHeading();
-        auto tmp = agent->getTile();
-        handlePerception(response, tmp);
-        response.x = tmp->getX();
-        response.y = tmp->getY();
+        response.heading = entities.getHeading(agent);
+        handlePerception(response, this->model->peekTile(agent));
+        response.x = entities.getX(agent);
+        response.y = entities.getY(agent);
     } else {
         auto wumpus = this->model->getWumpusByID(id);
-        auto tmp = wumpus->getTile();
-        response.x = tmp->getX();
-        response.y = tmp->getY();
+        response.x = entities.getX(wumpus);
+        response.y = entities.getY(wumpus);
     }
     response.responses.push_back(WumpusEnums::responses::yourTurn);
-    this->actionPub.publish(response);
+    if (this->legalActionMasks) {
+        response.legalActions = getLegalActions(id);
+    }
+    publishAction(response);
+    startTurnDeadline();
 }
 
-void WumpusSimulator::handlePerception(ActionResponse& msg, std::shared_ptr<GroundTile> tile)
+void WumpusSimulator::placeBaselineAgents()
 {
-    if (tile->getGold()) {
-        msg.responses.push_back(WumpusEnums::responses::shiny);
-    }
-    if (tile->getBreeze()) {
-        msg.responses.push_back(WumpusEnums::responses::drafty);
-    }
-    if (tile->getStench()) {
-        msg.responses.push_back(WumpusEnums::responses::stinky);
+    for (int id : this->baselineAgents.getIds()) {
+        // Evicted agents stay out like registered ones
+        if (std::find(this->registered.begin(), this->registered.end(), id) != this->registered.end() && !this->model->getAgentByID(id).isValid()) {
+            placeAgent(id, this->model->getAgentHasArrow());
+        }
     }
 }
 
-void WumpusSimulator::handleShootLeft(ActionResponse& msg, std::shared_ptr<Agent> agent)
+uint32_t WumpusSimulator::getLegalActions(int id)
 {
-    bool wumpusDead = false;
-    if (agent->getTile()->getY() == 0) {
-        msg.responses.push_back(WumpusEnums::responses::silence);
-    } else {
-        for (int i = agent->getTile()->getY() - 1; i >= 0; i--) {
-            if (this->getModel()->getPlayGround().at(agent->getTile()->getX()).at(i)->hasWumpus()) {
-                wumpusDead = true;
-                auto tmp = std::dynamic_pointer_cast<Wumpus>(this->getModel()->getPlayGround().at(agent->getTile()->getX()).at(i)->getMovable());
-                killWumpus(tmp);
-            }
+    auto& entities = this->model->entities;
+    int size = this->model->getPlayGroundSize();
+    uint32_t legal = 0;
+    if (id < 0) {
+        auto wumpus = this->model->getWumpusByID(id);
+        if (!wumpus.isValid()) {
+            return 0;
         }
-        if (wumpusDead) {
-            msg.responses.push_back(WumpusEnums::responses::scream);
-        } else {
-            msg.responses.push_back(WumpusEnums::responses::silence);
+        // Wumpus move into a direction and cannot leave the field or share a tile
+        for (int direction = 0; direction < 4; direction++) {
+            int x = entities.getX(wumpus) + WumpusEnums::stepX(direction);
+            int y = entities.getY(wumpus) + WumpusEnums::stepY(direction);
+            if (x >= 0 && y >= 0 && x < size && y < size && !this->model->peekTile(x, y)->hasWumpus()) {
+                legal |= 1 << direction;
+            }
         }
+        return legal;
     }
+
+    auto agent = this->model->getAgentByID(id);
+    if (!agent.isValid()) {
+        return 0;
+    }
+    auto tile = this->model->peekTile(entities.getX(agent), entities.getY(agent));
+    int heading = entities.getHeading(agent);
+    int x = entities.getX(agent) + WumpusEnums::stepX(heading);
+    int y = entities.getY(agent) + WumpusEnums::stepY(heading);
+    legal |= 1 << WumpusEnums::actions::turnLeft;
+    legal |= 1 << WumpusEnums::actions::turnRight;
+    // Other agents are not masked, they cannot be perceived
+    if (x >= 0 && y >= 0 && x < size && y < size) {
+        legal |= 1 << WumpusEnums::actions::move;
+    }
+    if (entities.hasArrow(agent)) {
+        legal |= 1 << WumpusEnums::actions::shoot;
+    }
+    if (tile->getGold()) {
+        legal |= 1 << WumpusEnums::actions::pickUpGold;
+    }
+    if (entities.hasGold(agent) && tile->getStartAgentID() == id) {
+        legal |= 1 << WumpusEnums::actions::leave;
+    }
+    return legal;
 }
 
-void WumpusSimulator::handleShootRight(ActionResponse& msg, std::shared_ptr<Agent> agent)
+template <class Rules>
+void WumpusSimulator::advanceTurn()
 {
-    bool wumpusDead = false;
-    if (agent->getTile()->getY() == this->model->getPlayGroundSize() - 1) {
-        msg.responses.push_back(WumpusEnums::responses::silence);
-    } else {
-        for (int i = agent->getTile()->getY() + 1; i <= this->model->getPlayGroundSize() - 1; i++) {
-            if (this->getModel()->getPlayGround().at(agent->getTile()->getX()).at(i)->hasWumpus()) {
-                wumpusDead = true;
-                auto tmp = std::dynamic_pointer_cast<Wumpus>(this->getModel()->getPlayGround().at(agent->getTile()->getX()).at(i)->getMovable());
-                killWumpus(tmp);
-            }
-        }
-        if (wumpusDead) {
-            msg.responses.push_back(WumpusEnums::responses::scream);
-        } else {
-            msg.responses.push_back(WumpusEnums::responses::silence);
+    if (this->turns.size() == 0) {
+        return;
+    }
+    getNext();
+    if (Rules::AUTONOMOUS_WUMPUS && this->turnIndex == 0) {
+        // A turn cycle is complete, move all wumpus that are controlled by the simulator
+        handleAutonomousWumpus();
+        if (this->turns.size() == 0) {
+            return;
         }
+        this->turnIndex = std::max(this->turnIndex, 0) % this->turns.size();
     }
 }
 
-void WumpusSimulator::handleShootUp(ActionResponse& msg, std::shared_ptr<Agent> agent)
+void WumpusSimulator::removeFromTurns(int id)
 {
-    bool wumpusDead = false;
-    if (agent->getTile()->getX() == 0) {
-        msg.responses.push_back(WumpusEnums::responses::silence);
+    auto it = std::find(this->turns.begin(), this->turns.end(), id);
+    if (it == this->turns.end()) {
+        return;
+    }
+    // Keep the index pointing at the same turn, so getNext continues with the right one
+    int index = it - this->turns.begin();
+    this->turns.erase(it);
+    if (this->turns.size() == 0) {
+        this->turnIndex = 0;
+    } else if (index <= this->turnIndex) {
+        this->turnIndex--;
+    }
+}
+
+void WumpusSimulator::startTurnDeadline()
+{
+    if (this->turnTimeout <= 0) {
+        return;
+    }
+    this->turnStart = ros::WallTime::now();
+    this->turnDeadlineArmed = true;
+}
+
+void WumpusSimulator::onTurnDeadline(const ros::WallTimerEvent& event)
+{
+    std::lock_guard<std::mutex> lock(simulationMutex);
+    if (!ready || !this->turnDeadlineArmed || this->turns.size() == 0) {
+        return;
+    }
+    if ((ros::WallTime::now() - this->turnStart).toSec() < this->turnTimeout) {
+        return;
+    }
+    // Announcing the next turn arms the deadline again
+    this->turnDeadlineArmed = false;
+    int id = this->turns.at(this->turnIndex);
+    int timeouts = ++this->consecutiveTimeouts[id];
+    Metrics::get()->increment(Metrics::timeouts);
+    this->scores.timeout(id);
+    std::cout << "WumpusSimulator: agent " << id << " missed its turn deadline (" << timeouts << " in a row)" << std::endl;
+
+    ActionResponse response;
+    response.agentId = id;
+    response.responses.push_back(WumpusEnums::responses::timedOut);
+    if (this->maxTimeouts > 0 && timeouts >= this->maxTimeouts) {
+        response.responses.push_back(WumpusEnums::responses::evicted);
+        publishAction(response);
+        evict(id);
     } else {
-        for (int i = agent->getTile()->getX() - 1; i >= 0; i--) {
-            if (this->getModel()->getPlayGround().at(i).at(agent->getTile()->getY())->hasWumpus()) {
-                wumpusDead = true;
-                auto tmp = std::dynamic_pointer_cast<Wumpus>(this->getModel()->getPlayGround().at(i).at(agent->getTile()->getY())->getMovable());
-                killWumpus(tmp);
-            }
+        this->penaltyTurns[id] = this->timeoutPenalty;
+        publishAction(response);
+    }
+    handleNextTurn();
+    checkEpisodeEnd();
+    publishSnapshot();
+}
+
+void WumpusSimulator::evict(int id)
+{
+    std::cout << "WumpusSimulator: evicting agent " << id << std::endl;
+    Metrics::get()->increment(Metrics::evictions);
+    removeFromTurns(id);
+    // Evicted agents are not respawned by the automatic reset
+    this->registered.erase(std::remove(this->registered.begin(), this->registered.end(), id), this->registered.end());
+    this->consecutiveTimeouts.erase(id);
+    this->penaltyTurns.erase(id);
+    if (id > 0) {
+        auto agent = this->model->getAgentByID(id);
+        if (agent.isValid()) {
+            this->model->exit(agent);
+            Metrics::get()->add(Metrics::liveAgents, -1);
+            this->scores.finish(id, ScoreBoard::evicted);
         }
-        if (wumpusDead) {
-            msg.responses.push_back(WumpusEnums::responses::scream);
-        } else {
-            msg.responses.push_back(WumpusEnums::responses::silence);
+    } else {
+        // Release the wumpus, it stays on the field like an unpossessed one
+        auto wumpus = this->model->getWumpusByID(id);
+        if (wumpus.isValid()) {
+            this->model->entities.setId(wumpus, 0);
         }
     }
 }
 
-void WumpusSimulator::handleShootDown(ActionResponse& msg, std::shared_ptr<Agent> agent)
+void WumpusSimulator::handlePerception(ActionResponse& msg, std::shared_ptr<GroundTile> tile)
+{
+    WUMPUS_TRACE("handlePerception");
+    auto& entry = perceptionTable[tile->getPerception() & (GroundTile::shinyMask | GroundTile::draftyMask | GroundTile::stinkyMask)];
+    msg.responses.insert(msg.responses.end(), entry.responses, entry.responses + entry.count);
+}
+
+void WumpusSimulator::shootArrow(ActionResponse& msg, EntityHandle agent)
 {
+    auto& entities = this->model->entities;
+    int heading = entities.getHeading(agent);
+    int size = this->model->getPlayGroundSize();
     bool wumpusDead = false;
-    if (agent->getTile()->getX() == this->model->getPlayGroundSize() - 1) {
-        msg.responses.push_back(WumpusEnums::responses::silence);
-    } else {
-        for (int i = agent->getTile()->getX() + 1; i <= this->model->getPlayGroundSize() - 1; i++) {
-            if (this->getModel()->getPlayGround().at(i).at(agent->getTile()->getY())->hasWumpus()) {
-                wumpusDead = true;
-                auto tmp = std::dynamic_pointer_cast<Wumpus>(this->getModel()->getPlayGround().at(i).at(agent->getTile()->getY())->getMovable());
-                killWumpus(tmp);
-            }
-        }
-        if (wumpusDead) {
-            msg.responses.push_back(WumpusEnums::responses::scream);
-        } else {
-            msg.responses.push_back(WumpusEnums::responses::silence);
+    int x = entities.getX(agent) + WumpusEnums::stepX(heading);
+    int y = entities.getY(agent) + WumpusEnums::stepY(heading);
+    for (; x >= 0 && y >= 0 && x < size && y < size; x += WumpusEnums::stepX(heading), y += WumpusEnums::stepY(heading)) {
+        auto tile = this->model->peekTile(x, y);
+        if (tile->hasWumpus()) {
+            wumpusDead = true;
+            killWumpus(tile->getEntity());
+            this->scores.kill(entities.getId(agent));
         }
     }
+    if (wumpusDead) {
+        msg.responses.push_back(WumpusEnums::responses::scream);
+    } else {
+        msg.responses.push_back(WumpusEnums::responses::silence);
+    }
 }
 
-void WumpusSimulator::killWumpus(std::shared_ptr<Wumpus> wumpus)
+void WumpusSimulator::killWumpus(EntityHandle wumpus)
 {
-    if (wumpus->getId() != 0) {
+    int id = this->model->entities.getId(wumpus);
+    if (id != 0) {
         ActionResponse response2;
-        response2.agentId = wumpus->getId();
+        response2.agentId = id;
         response2.responses.push_back(WumpusEnums::responses::dead);
-        this->actionPub.publish(response2);
-        this->turns.erase(std::find(this->turns.begin(), this->turns.end(), wumpus->getId()));
-    }
-    this->getModel()->removeWumpus(wumpus);
-    this->model->movables.erase(remove(this->model->movables.begin(), this->model->movables.end(), wumpus), this->model->movables.end());
-    for (auto mov : this->model->movables) {
-        if (mov->getId() <= 0) {
-            this->model->setStench(mov->getTile()->getX(), mov->getTile()->getY());
-        }
+        publishAction(response2);
+        removeFromTurns(id);
     }
-    emit modelChanged();
+    Metrics::get()->increment(Metrics::killedWumpus);
+    Metrics::get()->add(Metrics::liveWumpus, -1);
+    this->model->removeWumpus(wumpus);
+    this->model->entities.destroy(wumpus);
+    updateStench();
 }
 
-void WumpusSimulator::killAgent(std::shared_ptr<Agent> agent)
+void WumpusSimulator::killAgent(EntityHandle agent, ScoreBoard::outcome cause)
 {
-    this->turns.erase(std::find(this->turns.begin(), this->turns.end(), agent->getId()));
+    int id = this->model->entities.getId(agent);
+    removeFromTurns(id);
     ActionResponse response2;
-    response2.agentId = agent->getId();
+    response2.agentId = id;
     response2.responses.push_back(WumpusEnums::responses::dead);
-    this->actionPub.publish(response2);
+    publishAction(response2);
     this->model->exit(agent);
-    emit modelChanged();
+    Metrics::get()->increment(Metrics::deaths);
+    Metrics::get()->add(Metrics::liveAgents, -1);
+    this->scores.finish(id, cause);
+}
+
+void WumpusSimulator::selectRules()
+{
+    auto& entities = this->model->entities;
+    // Agents of a loaded world may still carry an arrow
+    bool arrow = this->model->getAgentHasArrow();
+    bool autonomousWumpus = false;
+    entities.forEach([&](EntityHandle entity) {
+        if (entities.getKind(entity) == EntityRegistry::agent) {
+            arrow = arrow || entities.hasArrow(entity);
+        } else if (entities.getId(entity) == 0 && entities.getBehaviour(entity) != nullptr) {
+            autonomousWumpus = true;
+        }
+    });
+    if (arrow && autonomousWumpus) {
+        useRules<RuleSet<true, true>>();
+    } else if (arrow) {
+        useRules<RuleSet<true, false>>();
+    } else if (autonomousWumpus) {
+        useRules<RuleSet<false, true>>();
+    } else {
+        useRules<RuleSet<false, false>>();
+    }
+}
+
+template <class Rules>
+void WumpusSimulator::useRules()
+{
+    this->actionHandler = &WumpusSimulator::applyAction<Rules>;
+    this->nextTurnHandler = &WumpusSimulator::applyNextTurn<Rules>;
 }
 
 void WumpusSimulator::getNext()
@@ -755,6 +1438,174 @@ void WumpusSimulator::getNext()
     this->turnIndex = turnIndex % this->turns.size();
 }
 
+void WumpusSimulator::updateLiveGauges()
+{
+    int agents = 0;
+    int wumpus = 0;
+    auto& entities = this->model->entities;
+    entities.forEach([&](EntityHandle entity) {
+        if (entities.getKind(entity) == EntityRegistry::agent) {
+            agents++;
+        } else {
+            wumpus++;
+        }
+    });
+    Metrics::get()->set(Metrics::liveAgents, agents);
+    Metrics::get()->set(Metrics::liveWumpus, wumpus);
+}
+
+void WumpusSimulator::beginEpisode()
+{
+    this->scores.beginEpisode(this->model->getSeed(), this->model->getPlayGroundSize(), this->model->getWumpusCount(), this->model->getTrapCount());
+}
+
+void WumpusSimulator::checkEpisodeEnd()
+{
+    if (this->autoReset && this->scores.isEpisodeOver()) {
+        resetEpisode();
+    }
+}
+
+void WumpusSimulator::resetEpisode()
+{
+    WUMPUS_TRACE("resetEpisode");
+    if (this->autoResetEpisodes > 0 && this->scores.getEpisodeCount() >= (uint32_t) this->autoResetEpisodes) {
+        std::cout << "WumpusSimulator: finished " << this->scores.getEpisodeCount() << " episodes, automatic reset stopped" << std::endl;
+        this->autoReset = false;
+        return;
+    }
+    if (!loadNextWorld()) {
+        this->autoReset = false;
+        return;
+    }
+    prepareWorld();
+    std::cout << "WumpusSimulator: starting episode " << this->scores.getEpisodeCount() + 1 << " with seed " << this->model->getSeed() << std::endl;
+
+    // Agents first, so one of them gets the first turn
+    for (int id : this->registered) {
+        if (id > 0) {
+            placeAgent(id, this->model->getAgentHasArrow());
+        }
+    }
+    for (int id : this->registered) {
+        if (id < 0) {
+            possessWumpus(id);
+        }
+    }
+    selectRules();
+}
+
+bool WumpusSimulator::loadNextWorld()
+{
+    if (!this->resetWorlds.empty()) {
+        if (this->nextResetWorld >= this->resetWorlds.size()) {
+            std::cout << "WumpusSimulator: all worlds of the index were played, automatic reset stopped" << std::endl;
+            return false;
+        }
+        auto record = this->worlds.get(this->resetWorlds.at(this->nextResetWorld++));
+        if (record == nullptr) {
+            return false;
+        }
+        this->model = Model::get();
+        this->model->fromRecord(*record);
+        return true;
+    }
+
+    // Without a schedule the seeds continue after the current world
+    unsigned int seed;
+    if (this->hasResetSeeds) {
+        if (this->nextResetSeed > this->lastResetSeed) {
+            std::cout << "WumpusSimulator: seed schedule finished, automatic reset stopped" << std::endl;
+            return false;
+        }
+        seed = this->nextResetSeed++;
+    } else {
+        seed = this->ready ? this->model->getSeed() + 1 : time(NULL);
+    }
+
+    // Keep the settings of the current world, the parameters are only needed for the first one
+    bool arrow;
+    int wumpus;
+    int traps;
+    int size;
+    if (this->ready) {
+        arrow = this->model->getAgentHasArrow();
+        wumpus = this->model->getWumpusCount();
+        traps = this->model->getTrapCount();
+        size = this->model->getPlayGroundSize();
+    } else {
+        n.param<bool>("/wumpus_simulator/world_arrow", arrow, true);
+        n.param<int>("/wumpus_simulator/world_wumpus", wumpus, 1);
+        n.param<int>("/wumpus_simulator/world_traps", traps, 2);
+        n.param<int>("/wumpus_simulator/world_size", size, 8);
+    }
+    bool solvable;
+    int generatorThreads;
+    n.param<bool>("/wumpus_simulator/solvable_worlds", solvable, false);
+    n.param<int>("/wumpus_simulator/generator_threads", generatorThreads, 0);
+    this->model = Model::get();
+    if (solvable) {
+        this->model->initSolvable(arrow, wumpus, traps, size, generatorThreads, seed);
+    } else {
+        this->model->init(arrow, wumpus, traps, size, seed);
+    }
+    return true;
+}
+
+void WumpusSimulator::onMetricsTimer(const ros::WallTimerEvent& event)
+{
+    auto metrics = Metrics::get();
+    auto now = ros::WallTime::now();
+    uint64_t actions = metrics->get(Metrics::actions);
+    double elapsed = (now - this->lastMetricsTime).toSec();
+
+    SimulatorStats stats;
+    stats.actionsPerSecond = elapsed > 0 ? (actions - this->lastMetricsActions) / elapsed : 0;
+    stats.actions = actions;
+    stats.rejectedActions = metrics->get(Metrics::rejectedActions);
+    stats.spawns = metrics->get(Metrics::spawns);
+    stats.deaths = metrics->get(Metrics::deaths);
+    stats.exits = metrics->get(Metrics::exits);
+    stats.killedWumpus = metrics->get(Metrics::killedWumpus);
+    stats.timeouts = metrics->get(Metrics::timeouts);
+    stats.evictions = metrics->get(Metrics::evictions);
+    stats.liveAgents = metrics->get(Metrics::liveAgents);
+    stats.liveWumpus = metrics->get(Metrics::liveWumpus);
+    stats.pendingActions = metrics->get(Metrics::pendingActions);
+    stats.lastRenderMillis = metrics->get(Metrics::lastRenderMicros) / 1000.0;
+    uint64_t renders = metrics->get(Metrics::renders);
+    stats.averageRenderMillis = renders > 0 ? metrics->get(Metrics::renderMicros) / 1000.0 / renders : 0;
+    this->statsPub.publish(stats);
+
+    if (!this->metricsFile.empty() && !metrics->writePrometheus(this->metricsFile)) {
+        std::cout << "WumpusSimulator: couldn't write metrics file " << this->metricsFile << std::endl;
+    }
+    this->lastMetricsActions = actions;
+    this->lastMetricsTime = now;
+}
+
+void WumpusSimulator::publishAction(ActionResponse& response)
+{
+    WUMPUS_TRACE("actionPub.publish");
+    if (this->hashResponses) {
+        response.worldHash = this->model->getHash();
+    }
+    if (this->baselineAgents.contains(response.agentId)) {
+        this->baselineAgents.deliver(response);
+        return;
+    }
+    this->actionPub.publish(response);
+}
+
+void WumpusSimulator::onFlushTrace(std_msgs::EmptyConstPtr msg)
+{
+    if (Tracer::get()->flush(traceFile)) {
+        std::cout << "WumpusSimulator: trace written to " << traceFile << std::endl;
+    } else {
+        std::cout << "WumpusSimulator: couldn't write trace to " << traceFile << std::endl;
+    }
+}
+
 } // namespace wumpus_simulator
 
 PLUGINLIB_EXPORT_CLASS(wumpus_simulator::WumpusSimulator, rqt_gui_cpp::Plugin)
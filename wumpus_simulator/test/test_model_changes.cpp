@@ -0,0 +1,100 @@
+/**
+ * T License (MIT)
+ *
+ * Copyright (c) 2018 Distributed Systems Group, University of Kassel, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "model/GroundTile.h"
+#include "model/Model.h"
+#include "model/WorldLibrary.h"
+
+#include <gtest/gtest.h>
+
+using namespace wumpus_simulator;
+
+namespace
+{
+/**
+ * Places an agent like WumpusSimulator::spawnAgent does and drains the resulting changes
+ */
+EntityHandle spawnAgent(Model& model, int agentId)
+{
+    std::minstd_rand random(model.getSeed());
+    int x;
+    int y;
+    EXPECT_TRUE(model.pickSpawnTile(random, x, y));
+    auto tile = model.getTile(x, y);
+    auto agent = model.entities.create(EntityRegistry::agent, agentId, x, y);
+    tile->setEntity(agent, EntityRegistry::agent);
+    tile->setStartAgentID(agentId);
+    tile->setStartpoint(true);
+    WorldRecord changes;
+    model.takeChanges(changes);
+    model.takeSnapshot(nullptr);
+    return agent;
+}
+} // namespace
+
+TEST(ModelChanges, PerceptionRoundLeavesNoChanges)
+{
+    Model model;
+    model.setQuiet(true);
+    model.init(true, 5, 5, 64, 1);
+    auto agent = spawnAgent(model, 1);
+    auto previous = model.takeSnapshot(nullptr);
+
+    // What announceTurn, a failed shot, pickup and exit read from the tile of the agent
+    auto tile = model.peekTile(agent);
+    tile->getPerception();
+    tile->getGold();
+    tile->getStartAgentID();
+
+    WorldRecord changes;
+    model.takeChanges(changes);
+    EXPECT_TRUE(changes.tiles.empty());
+    auto snapshot = model.takeSnapshot(previous);
+    ASSERT_EQ(previous->pages.size(), snapshot->pages.size());
+    for (size_t i = 0; i < snapshot->pages.size(); i++) {
+        EXPECT_EQ(previous->pages[i], snapshot->pages[i]);
+    }
+}
+
+TEST(ModelChanges, TurningReportsOnlyTheTileOfTheAgent)
+{
+    Model model;
+    model.setQuiet(true);
+    model.init(true, 5, 5, 64, 1);
+    auto agent = spawnAgent(model, 1);
+
+    model.entities.setHeading(agent, WumpusEnums::heading::left);
+    WorldRecord changes;
+    model.takeChanges(changes);
+    ASSERT_EQ(1u, changes.tiles.size());
+    EXPECT_EQ(model.entities.getX(agent), changes.tiles[0].x);
+    EXPECT_EQ(model.entities.getY(agent), changes.tiles[0].y);
+    EXPECT_EQ(WumpusEnums::heading::left, changes.tiles[0].agentHeading);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}